@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+//
+// Sum, min/max and histogram kernels over a std::generator<float>, as a
+// value-at-a-time loop over the iterator and as for_each_batch() with a
+// block kernel. The producer either computes and yields every value or
+// yields slices of a vector via elements_of(). Items are values.
+//
+#include <generator>
+#include <experimental/batch>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace {
+
+constexpr std::size_t block = 1024;
+
+std::generator<float> computed(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<float>(i % 1000) * 0.25f;
+    }
+}
+
+const std::vector<float>& table() {
+    static const std::vector<float> t = [] {
+        std::vector<float> v(4096);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            v[i] = static_cast<float>(i % 1000) * 0.25f;
+        }
+        return v;
+    }();
+    return t;
+}
+
+std::generator<float> sliced(std::size_t n) {
+    const std::vector<float>& t = table();
+    for (std::size_t i = 0; i < n; i += t.size()) {
+        co_yield std::ranges::elements_of(std::span<const float>(t).first(std::min(t.size(), n - i)));
+    }
+}
+
+struct sum_kernel {
+    float lanes[16] = {};
+
+    void operator()(float x) {
+        lanes[0] += x;
+    }
+
+    void operator()(std::span<const float> values) {
+        std::size_t i = 0;
+        for (; i + 16 <= values.size(); i += 16) {
+            for (std::size_t j = 0; j < 16; ++j) {
+                lanes[j] += values[i + j];
+            }
+        }
+        for (; i < values.size(); ++i) {
+            lanes[0] += values[i];
+        }
+    }
+
+    float result() const {
+        float total = 0;
+        for (float l : lanes) {
+            total += l;
+        }
+        return total;
+    }
+};
+
+struct minmax_kernel {
+    float lo[16];
+    float hi[16];
+
+    minmax_kernel() {
+        std::fill(std::begin(lo), std::end(lo), 1e30f);
+        std::fill(std::begin(hi), std::end(hi), -1e30f);
+    }
+
+    void operator()(float x) {
+        lo[0] = x < lo[0] ? x : lo[0];
+        hi[0] = x > hi[0] ? x : hi[0];
+    }
+
+    void operator()(std::span<const float> values) {
+        std::size_t i = 0;
+        for (; i + 16 <= values.size(); i += 16) {
+            for (std::size_t j = 0; j < 16; ++j) {
+                const float x = values[i + j];
+                lo[j] = x < lo[j] ? x : lo[j];
+                hi[j] = x > hi[j] ? x : hi[j];
+            }
+        }
+        for (; i < values.size(); ++i) {
+            (*this)(values[i]);
+        }
+    }
+
+    float result() const {
+        return *std::max_element(std::begin(hi), std::end(hi)) -
+               *std::min_element(std::begin(lo), std::end(lo));
+    }
+};
+
+struct histogram_kernel {
+    std::uint32_t buckets[256] = {};
+
+    void operator()(float x) {
+        ++buckets[static_cast<std::uint32_t>(x) & 255];
+    }
+
+    void operator()(std::span<const float> values) {
+        for (float x : values) {
+            ++buckets[static_cast<std::uint32_t>(x) & 255];
+        }
+    }
+
+    std::uint32_t result() const {
+        return buckets[7];
+    }
+};
+
+template <typename Kernel, typename Producer>
+void scalar(std::size_t n, Producer producer) {
+    Kernel k;
+    for (float x : producer(n)) {
+        k(x);
+    }
+    bench::do_not_optimize(k.result());
+}
+
+template <typename Kernel, typename Producer>
+void batched(std::size_t n, Producer producer) {
+    Kernel k;
+    std::experimental::for_each_batch(producer(n), block, [&](std::span<const float> values) {
+        k(values);
+    });
+    bench::do_not_optimize(k.result());
+}
+
+template <typename Kernel>
+void run_kernel(bench::runner& runner, const std::string& name) {
+    runner.run(name + "/computed/scalar", [](std::size_t n) { scalar<Kernel>(n, computed); });
+    runner.run(name + "/computed/batched", [](std::size_t n) { batched<Kernel>(n, computed); });
+    runner.run(name + "/sliced/scalar", [](std::size_t n) { scalar<Kernel>(n, sliced); });
+    runner.run(name + "/sliced/batched", [](std::size_t n) { batched<Kernel>(n, sliced); });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    run_kernel<sum_kernel>(runner, "sum");
+    run_kernel<minmax_kernel>(runner, "minmax");
+    run_kernel<histogram_kernel>(runner, "histogram");
+
+    return runner.report();
+}
@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#ifndef BENCHMARK_HPP_INCLUDED
+#define BENCHMARK_HPP_INCLUDED
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal self-contained benchmark harness.
+//
+// Each benchmark is a callable taking the number of items to process. The
+// harness calibrates the item count until a single run takes at least
+// --min-time seconds, then takes --repetitions samples and reports the
+// per-item time of the fastest and median samples as JSON on stdout (or to
+// the file named by --json).
+//
+// Usage: <benchmark> [--filter=<substring>] [--repetitions=<n>]
+//                    [--min-time=<seconds>] [--json=<path>]
+
+namespace bench {
+
+// Prevent the compiler from optimising away a computed value.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct result {
+    std::string name;
+    std::size_t items;
+    std::size_t repetitions;
+    double ns_per_item_min;
+    double ns_per_item_median;
+};
+
+class runner {
+public:
+    runner(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            if (std::strncmp(arg, "--filter=", 9) == 0) {
+                filter_ = arg + 9;
+            } else if (std::strncmp(arg, "--repetitions=", 14) == 0) {
+                repetitions_ = std::max(1, std::atoi(arg + 14));
+            } else if (std::strncmp(arg, "--min-time=", 11) == 0) {
+                minTime_ = std::atof(arg + 11);
+            } else if (std::strncmp(arg, "--json=", 7) == 0) {
+                jsonPath_ = arg + 7;
+            } else {
+                std::fprintf(stderr, "unknown argument '%s'\n", arg);
+                std::exit(2);
+            }
+        }
+    }
+
+    // Run 'f(n)' where 'n' is the number of items it should process.
+    template <typename F>
+    void run(const std::string& name, F&& f) {
+        if (!filter_.empty() && name.find(filter_) == std::string::npos) {
+            return;
+        }
+
+        std::fprintf(stderr, "-> %s\n", name.c_str());
+
+        // Calibrate the number of items so a single run exceeds the minimum time.
+        std::size_t items = 1;
+        for (;;) {
+            const double seconds = time(f, items);
+            if (seconds >= minTime_ || items >= (std::size_t(1) << 40)) {
+                break;
+            }
+            const double scale = seconds > 0 ? (minTime_ * 1.2) / seconds : 100.0;
+            items = std::max(items * 2, static_cast<std::size_t>(items * std::min(scale, 100.0)));
+        }
+
+        std::vector<double> samples;
+        samples.reserve(static_cast<std::size_t>(repetitions_));
+        for (int i = 0; i < repetitions_; ++i) {
+            samples.push_back(time(f, items) * 1e9 / static_cast<double>(items));
+        }
+        std::sort(samples.begin(), samples.end());
+
+        results_.push_back(result{
+            name, items, samples.size(), samples.front(), samples[samples.size() / 2]});
+    }
+
+    // Write all results as JSON. Returns the process exit code.
+    int report() const {
+        std::FILE* out = stdout;
+        if (!jsonPath_.empty()) {
+            out = std::fopen(jsonPath_.c_str(), "w");
+            if (out == nullptr) {
+                std::fprintf(stderr, "failed to open '%s'\n", jsonPath_.c_str());
+                return 1;
+            }
+        }
+
+        std::fprintf(out, "{\n");
+        std::fprintf(out, "  \"context\": {\n");
+        std::fprintf(out, "    \"compiler\": \"%s\",\n", compiler());
+        std::fprintf(out, "    \"optimized\": %s,\n", optimized() ? "true" : "false");
+        std::fprintf(out, "    \"repetitions\": %d,\n", repetitions_);
+        std::fprintf(out, "    \"min_time_s\": %g\n", minTime_);
+        std::fprintf(out, "  },\n");
+        std::fprintf(out, "  \"benchmarks\": [");
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const result& r = results_[i];
+            std::fprintf(out, "%s\n    {\"name\": \"%s\", \"items\": %zu, \"repetitions\": %zu, "
+                              "\"ns_per_item_min\": %.4f, \"ns_per_item_median\": %.4f}",
+                         i == 0 ? "" : ",",
+                         r.name.c_str(), r.items, r.repetitions,
+                         r.ns_per_item_min, r.ns_per_item_median);
+        }
+        std::fprintf(out, "\n  ]\n}\n");
+
+        if (out != stdout) {
+            std::fclose(out);
+        }
+        return 0;
+    }
+
+private:
+    template <typename F>
+    static double time(F& f, std::size_t items) {
+        const auto start = std::chrono::steady_clock::now();
+        f(items);
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(stop - start).count();
+    }
+
+    static const char* compiler() noexcept {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc";
+#else
+        return "unknown";
+#endif
+    }
+
+    static constexpr bool optimized() noexcept {
+#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && !defined(_DEBUG))
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::string filter_;
+    std::string jsonPath_;
+    int repetitions_ = 5;
+    double minTime_ = 0.05;
+    std::vector<result> results_;
+};
+
+} // namespace bench
+
+#endif
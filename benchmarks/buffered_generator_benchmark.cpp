@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/buffered_generator>
+#include <cstddef>
+
+#include "benchmark.hpp"
+
+namespace {
+
+std::generator<int> iota(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<int>(i);
+    }
+}
+
+template <std::size_t N>
+std::experimental::buffered_generator<int, N> buffered_iota(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<int>(i);
+    }
+}
+
+void sum_generator(std::size_t n) {
+    long long sum = 0;
+    for (int x : iota(n)) {
+        sum += x;
+    }
+    bench::do_not_optimize(sum);
+}
+
+template <std::size_t N>
+void sum_buffered(std::size_t n) {
+    long long sum = 0;
+    for (int x : buffered_iota<N>(n)) {
+        sum += x;
+    }
+    bench::do_not_optimize(sum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    runner.run("sum_int/generator", sum_generator);
+    runner.run("sum_int/buffered_8", sum_buffered<8>);
+    runner.run("sum_int/buffered_64", sum_buffered<64>);
+    runner.run("sum_int/buffered_256", sum_buffered<256>);
+
+    return runner.report();
+}
@@ -0,0 +1,96 @@
+# Copyright Lewis Baker, Corentin Jabot
+# Licensed under Boost Software License 1.0
+
+# Times building the translation units of the compile-time benchmark (see
+# CMakeLists.txt in this directory) against the <generator> header and, if
+# the build tree has STDGENERATOR_BUILD_MODULE on, against the stdgenerator
+# module.
+#
+# Usage: cmake -DBUILD_DIR=<build dir> [-DREPETITIONS=<n>] [-DJOBS=<n>]
+#              [-DJSON=<path>] -P compile_time_benchmark.cmake
+#
+# Each variant is built once untimed, so the module interface and everything
+# else the units depend on is up to date. Its sources are then touched and
+# rebuilt REPETITIONS times, which recompiles just those units. The results
+# are written as JSON in the same layout as the other benchmarks, with the
+# time per translation unit in milliseconds.
+
+cmake_minimum_required(VERSION 3.23)
+
+if(NOT DEFINED BUILD_DIR)
+    message(FATAL_ERROR "usage: cmake -DBUILD_DIR=<build dir> -P ${CMAKE_CURRENT_LIST_FILE}")
+endif()
+if(NOT DEFINED REPETITIONS)
+    set(REPETITIONS 3)
+endif()
+if(NOT DEFINED JOBS)
+    set(JOBS 1)
+endif()
+
+include(${BUILD_DIR}/benchmarks/compile_time_benchmark_config.cmake)
+
+function(build_variant variant)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR} --target compile_time_${variant}
+                --parallel ${JOBS}
+        OUTPUT_QUIET
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "building compile_time_${variant} failed")
+    endif()
+endfunction()
+
+# Microseconds since the epoch: the seconds followed by the six digits of
+# the fraction.
+function(now out)
+    string(TIMESTAMP value "%s%f" UTC)
+    set(${out} ${value} PARENT_SCOPE)
+endfunction()
+
+# Formats a count of microseconds per unit as milliseconds.
+function(format_ms micros out)
+    math(EXPR whole "${micros} / 1000")
+    math(EXPR fraction "${micros} % 1000")
+    string(LENGTH "${fraction}" length)
+    while(length LESS 3)
+        string(PREPEND fraction "0")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    set(${out} "${whole}.${fraction}" PARENT_SCOPE)
+endfunction()
+
+set(entries "")
+foreach(variant IN LISTS compile_time_variants)
+    message(STATUS "-> compile/${variant}")
+    build_variant(${variant})
+    set(samples "")
+    foreach(repetition RANGE 1 ${REPETITIONS})
+        file(TOUCH ${compile_time_sources_${variant}})
+        now(start)
+        build_variant(${variant})
+        now(stop)
+        math(EXPR per_unit "(${stop} - ${start}) / ${compile_time_units}")
+        list(APPEND samples ${per_unit})
+    endforeach()
+    list(SORT samples COMPARE NATURAL)
+    list(GET samples 0 fastest)
+    math(EXPR middle "${REPETITIONS} / 2")
+    list(GET samples ${middle} median)
+    format_ms(${fastest} fastest_ms)
+    format_ms(${median} median_ms)
+    message(STATUS "   ${median_ms} ms per translation unit")
+    if(NOT entries STREQUAL "")
+        string(APPEND entries ",")
+    endif()
+    string(APPEND entries "\n    {\"name\": \"compile/${variant}\", \"items\": ${compile_time_units}, "
+                          "\"repetitions\": ${REPETITIONS}, \"ms_per_item_min\": ${fastest_ms}, "
+                          "\"ms_per_item_median\": ${median_ms}}")
+endforeach()
+
+set(json "{\n  \"context\": {\n    \"jobs\": ${JOBS},\n    \"repetitions\": ${REPETITIONS}\n  },\n")
+string(APPEND json "  \"benchmarks\": [${entries}\n  ]\n}\n")
+if(DEFINED JSON)
+    file(WRITE ${JSON} "${json}")
+else()
+    message("${json}")
+endif()
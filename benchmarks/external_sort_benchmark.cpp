@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+//
+// external_sort() of 4 MiB of random 32-bit values with a budget that holds
+// all of them, and with budgets that spill 4 and 32 runs to disk, compared
+// with collecting the values into a vector and calling std::sort. Spill
+// files go to the system temporary directory. Items are values sorted.
+//
+#include <generator>
+#include <experimental/external_sort>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace {
+
+constexpr std::size_t values_per_sort = 1 << 20;
+
+std::generator<std::uint32_t> random_values(std::size_t n) {
+    std::minstd_rand rng(1);
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<std::uint32_t>(rng());
+    }
+}
+
+void vector_sort(std::size_t n) {
+    std::uint64_t sum = 0;
+    for (std::size_t round = 0; round < (n + values_per_sort - 1) / values_per_sort; ++round) {
+        std::vector<std::uint32_t> values;
+        random_values(std::min(n, values_per_sort)).drain_into(values);
+        std::sort(values.begin(), values.end());
+        for (std::uint32_t x : values) {
+            sum = sum * 31 + x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+void external(std::size_t n, std::size_t budget) {
+    std::uint64_t sum = 0;
+    for (std::size_t round = 0; round < (n + values_per_sort - 1) / values_per_sort; ++round) {
+        for (std::uint32_t x : std::experimental::external_sort(random_values(std::min(n, values_per_sort)), budget)) {
+            sum = sum * 31 + x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    constexpr std::size_t bytes = values_per_sort * sizeof(std::uint32_t);
+    runner.run("sort/vector", vector_sort);
+    runner.run("sort/external_in_memory", [](std::size_t n) { external(n, bytes); });
+    runner.run("sort/external_4_runs", [](std::size_t n) { external(n, bytes / 4); });
+    runner.run("sort/external_32_runs", [](std::size_t n) { external(n, bytes / 32); });
+
+    return runner.report();
+}
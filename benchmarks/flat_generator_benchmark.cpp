@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/flat_generator>
+#include <experimental/frame_pool>
+#include <cstddef>
+
+#include "benchmark.hpp"
+
+namespace {
+
+using pooled = std::experimental::frame_pool_allocator<std::byte>;
+
+template <template <typename...> class Gen, typename Alloc = std::allocator<std::byte>>
+Gen<int, int, Alloc> iota(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<int>(i);
+    }
+}
+
+template <template <typename...> class Gen>
+void sum_iota(std::size_t n) {
+    long long sum = 0;
+    for (int x : iota<Gen>(n)) {
+        sum += x;
+    }
+    bench::do_not_optimize(sum);
+}
+
+// Many short-lived leaf generators, as produced by a hot loop that creates
+// one generator per input. Uses a pooled allocator so that the difference
+// in frame setup, not the heap, dominates.
+template <template <typename...> class Gen>
+void short_leaves(std::size_t n) {
+    constexpr std::size_t per_leaf = 4;
+    long long sum = 0;
+    for (std::size_t i = 0; i < (n + per_leaf - 1) / per_leaf; ++i) {
+        for (int x : iota<Gen, pooled>(per_leaf)) {
+            sum += x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    using std::experimental::flat_generator;
+
+    runner.run("iterate/generator", sum_iota<std::generator>);
+    runner.run("iterate/flat_generator", sum_iota<flat_generator>);
+
+    runner.run("short_leaves/generator", short_leaves<std::generator>);
+    runner.run("short_leaves/flat_generator", short_leaves<flat_generator>);
+
+    return runner.report();
+}
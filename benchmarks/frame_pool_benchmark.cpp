@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/frame_pool>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace {
+
+using std::experimental::frame_pool_allocator;
+
+using default_generator = std::generator<int, int, std::allocator<std::byte>>;
+using pooled_generator = std::generator<int, int, frame_pool_allocator<std::byte>>;
+
+default_generator single_default() {
+    co_yield 1;
+}
+
+pooled_generator single_pooled() {
+    co_yield 1;
+}
+
+std::generator<int> single_allocator_arg(std::allocator_arg_t, frame_pool_allocator<std::byte>) {
+    co_yield 1;
+}
+
+default_generator tree_default(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(tree_default(depth - 1));
+        co_yield std::ranges::elements_of(tree_default(depth - 1));
+    }
+}
+
+pooled_generator tree_pooled(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(tree_pooled(depth - 1));
+        co_yield std::ranges::elements_of(tree_pooled(depth - 1));
+    }
+}
+
+template <typename Factory>
+void create_and_consume(std::size_t n, Factory factory) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (int x : factory()) {
+            sum += x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+// Frames created on one thread and destroyed on another.
+template <typename Factory>
+void create_and_consume_remote(std::size_t n, Factory factory) {
+    using generator_t = decltype(factory());
+    constexpr std::size_t batch = 1024;
+    std::vector<generator_t> gens;
+    gens.reserve(batch);
+    for (std::size_t done = 0; done < n; done += batch) {
+        const std::size_t count = std::min(batch, n - done);
+        for (std::size_t i = 0; i < count; ++i) {
+            gens.push_back(factory());
+        }
+        std::thread([&] { gens.clear(); }).join();
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    runner.run("create_destroy/default", [](std::size_t n) {
+        create_and_consume(n, [] { return single_default(); });
+    });
+    runner.run("create_destroy/frame_pool", [](std::size_t n) {
+        create_and_consume(n, [] { return single_pooled(); });
+    });
+    runner.run("create_destroy/frame_pool_allocator_arg", [](std::size_t n) {
+        create_and_consume(n, [] {
+            return single_allocator_arg(std::allocator_arg, frame_pool_allocator<std::byte>{});
+        });
+    });
+
+    // A binary tree of depth 10 has 2047 frames.
+    runner.run("recursive_tree/default", [](std::size_t n) {
+        create_and_consume((n + 2046) / 2047, [] { return tree_default(10); });
+    });
+    runner.run("recursive_tree/frame_pool", [](std::size_t n) {
+        create_and_consume((n + 2046) / 2047, [] { return tree_pooled(10); });
+    });
+
+    runner.run("cross_thread_destroy/default", [](std::size_t n) {
+        create_and_consume_remote(n, [] { return single_default(); });
+    });
+    runner.run("cross_thread_destroy/frame_pool", [](std::size_t n) {
+        create_and_consume_remote(n, [] { return single_pooled(); });
+    });
+
+    return runner.report();
+}
@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace {
+
+using typed_generator = std::generator<int, int, std::allocator<std::byte>>;
+using erased_generator = std::generator<int>;
+
+typed_generator iota_typed(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<int>(i);
+    }
+}
+
+erased_generator iota_erased(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<int>(i);
+    }
+}
+
+std::generator<const std::string&> repeat_string(const std::string& s, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield s;
+    }
+}
+
+// Value-typed generator yielding a local it keeps updating.
+std::generator<std::string> numbered_lines(std::size_t n) {
+    std::string line(64, 'x');
+    for (std::size_t i = 0; i < n; ++i) {
+        line[0] = static_cast<char>('0' + i % 10);
+        co_yield line;
+    }
+}
+
+std::generator<std::vector<int>> rows(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield std::vector<int>(64, static_cast<int>(i));
+    }
+}
+
+// Chain of 'depth' nested generators with the leaf yielding 'n' values.
+erased_generator nested(std::size_t depth, std::size_t n) {
+    if (depth == 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+            co_yield static_cast<int>(i);
+        }
+    } else {
+        co_yield std::ranges::elements_of(nested(depth - 1, n));
+    }
+}
+
+// Nests a generator whose reference type converts to, but is not, long long.
+std::generator<long long> widened(std::size_t n) {
+    co_yield std::ranges::elements_of(iota_erased(n));
+}
+
+erased_generator yield_vector(const std::vector<int>& v) {
+    co_yield std::ranges::elements_of(v);
+}
+
+erased_generator iota_with_hint(std::size_t n) {
+    co_yield std::ranges::size_hint(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<int>(i);
+    }
+}
+
+erased_generator single_default() {
+    co_yield 1;
+}
+
+erased_generator single_allocator_arg(std::allocator_arg_t, std::allocator<std::byte>) {
+    co_yield 1;
+}
+
+typed_generator single_typed() {
+    co_yield 1;
+}
+
+// Hand-written iterator producing the same sequence as iota_typed().
+struct iota_range {
+    struct iterator {
+        std::size_t i;
+        int operator*() const noexcept { return static_cast<int>(i); }
+        iterator& operator++() noexcept { ++i; return *this; }
+        bool operator==(const iterator&) const = default;
+    };
+
+    std::size_t n;
+    iterator begin() const noexcept { return {0}; }
+    iterator end() const noexcept { return {n}; }
+};
+
+template <typename Range>
+void sum_all(Range&& r) {
+    long long sum = 0;
+    for (auto&& x : r) {
+        sum += x;
+    }
+    bench::do_not_optimize(sum);
+}
+
+template <typename Factory>
+void create_and_consume(std::size_t n, Factory factory) {
+    for (std::size_t i = 0; i < n; ++i) {
+        sum_all(factory());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    runner.run("iterate/typed_generator", [](std::size_t n) { sum_all(iota_typed(n)); });
+    runner.run("iterate/erased_generator", [](std::size_t n) { sum_all(iota_erased(n)); });
+    runner.run("iterate/baseline_hand_written_iterator", [](std::size_t n) {
+        sum_all(iota_range{n});
+    });
+
+    runner.run("dereference/const_string_ref", [](std::size_t n) {
+        const std::string s(64, 'x');
+        std::size_t total = 0;
+        for (const std::string& x : repeat_string(s, n)) {
+            total += x.size();
+        }
+        bench::do_not_optimize(total);
+    });
+
+    runner.run("yield_lvalue/string", [](std::size_t n) {
+        std::size_t total = 0;
+        for (const std::string& x : numbered_lines(n)) {
+            total += static_cast<std::size_t>(x[0]);
+        }
+        bench::do_not_optimize(total);
+    });
+
+    for (std::size_t depth : {1, 10, 100, 1000}) {
+        runner.run("nested/elements_of_depth_" + std::to_string(depth), [depth](std::size_t n) {
+            sum_all(nested(depth, n));
+        });
+    }
+
+    runner.run("nested/elements_of_convertible_reference", [](std::size_t n) {
+        sum_all(widened(n));
+    });
+
+    runner.run("elements_of/vector", [](std::size_t n) {
+        const std::vector<int> v(n, 1);
+        sum_all(yield_vector(v));
+    });
+    runner.run("elements_of/baseline_vector_loop", [](std::size_t n) {
+        const std::vector<int> v(n, 1);
+        sum_all(v);
+    });
+
+    runner.run("materialise/push_back_loop", [](std::size_t n) {
+        std::vector<int> v;
+        for (int x : iota_erased(n)) {
+            v.push_back(x);
+        }
+        bench::do_not_optimize(v.data());
+    });
+    runner.run("materialise/drain_into", [](std::size_t n) {
+        std::vector<int> v;
+        iota_erased(n).drain_into(v);
+        bench::do_not_optimize(v.data());
+    });
+    runner.run("materialise/drain_into_size_hint", [](std::size_t n) {
+        std::vector<int> v;
+        iota_with_hint(n).drain_into(v);
+        bench::do_not_optimize(v.data());
+    });
+    runner.run("materialise/drain_into_elements_of_vector", [](std::size_t n) {
+        const std::vector<int> source(n, 1);
+        std::vector<int> v;
+        yield_vector(source).drain_into(v);
+        bench::do_not_optimize(v.data());
+    });
+
+    runner.run("materialise/rows_dereference", [](std::size_t n) {
+        std::vector<std::vector<int>> v;
+        for (auto&& row : rows(n)) {
+            v.push_back(row);
+        }
+        bench::do_not_optimize(v.data());
+    });
+    runner.run("materialise/rows_take", [](std::size_t n) {
+        std::vector<std::vector<int>> v;
+        auto g = rows(n);
+        for (auto it = g.begin(); it != g.end(); ++it) {
+            v.push_back(it.take());
+        }
+        bench::do_not_optimize(v.data());
+    });
+
+    runner.run("frame_allocation/default", [](std::size_t n) {
+        create_and_consume(n, [] { return single_default(); });
+    });
+    runner.run("frame_allocation/allocator_arg", [](std::size_t n) {
+        create_and_consume(n, [] {
+            return single_allocator_arg(std::allocator_arg, std::allocator<std::byte>{});
+        });
+    });
+    runner.run("frame_allocation/typed_allocator", [](std::size_t n) {
+        create_and_consume(n, [] { return single_typed(); });
+    });
+
+    return runner.report();
+}
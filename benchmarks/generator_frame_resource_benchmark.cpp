@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/generator_frame_resource>
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+#include "benchmark.hpp"
+
+namespace {
+
+using std::experimental::generator_frame_resource;
+
+using allocator_t = std::pmr::polymorphic_allocator<>;
+
+std::generator<int> single_default() {
+    co_yield 1;
+}
+
+// GCC pairs the frame's templated placement operator new with the class's
+// sized operator delete as a mismatch when not optimising, although the
+// delete is the one the coroutine must call.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+std::pmr::generator<int> single_pmr(std::allocator_arg_t, allocator_t) {
+    co_yield 1;
+}
+
+std::generator<int> tree_default(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(tree_default(depth - 1));
+        co_yield std::ranges::elements_of(tree_default(depth - 1));
+    }
+}
+
+std::pmr::generator<int> tree_pmr(std::allocator_arg_t, allocator_t alloc, int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(tree_pmr(std::allocator_arg, alloc, depth - 1));
+        co_yield std::ranges::elements_of(tree_pmr(std::allocator_arg, alloc, depth - 1));
+    }
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+template <typename Factory>
+void create_and_consume(std::size_t n, Factory factory) {
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (int x : factory()) {
+            sum += x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+// Stands for new_delete_resource(), so that allocations go to the heap.
+struct heap {};
+
+std::pmr::memory_resource* resource_of(heap&) {
+    return std::pmr::new_delete_resource();
+}
+
+std::pmr::memory_resource* resource_of(std::pmr::memory_resource& resource) {
+    return &resource;
+}
+
+// Runs 'f(resource, count)' with counts adding up to 'n', on a fresh
+// Resource every 'round' so that a monotonic_buffer_resource, which never
+// reuses freed memory, does not grow without bound.
+template <typename Resource, typename F>
+void in_rounds(std::size_t n, std::size_t round, F f) {
+    for (std::size_t done = 0; done < n; done += round) {
+        Resource resource;
+        f(resource_of(resource), std::min(round, n - done));
+    }
+}
+
+template <typename Resource>
+void create_destroy(bench::runner& runner, const char* name) {
+    runner.run(std::string("create_destroy/") + name, [](std::size_t n) {
+        in_rounds<Resource>(n, 4096, [](std::pmr::memory_resource* resource, std::size_t count) {
+            create_and_consume(count, [&] { return single_pmr(std::allocator_arg, resource); });
+        });
+    });
+}
+
+// A binary tree of depth 10 has 2047 frames.
+template <typename Resource>
+void recursive_tree(bench::runner& runner, const char* name) {
+    runner.run(std::string("recursive_tree/") + name, [](std::size_t n) {
+        in_rounds<Resource>((n + 2046) / 2047, 2, [](std::pmr::memory_resource* resource, std::size_t count) {
+            create_and_consume(count, [&] { return tree_pmr(std::allocator_arg, resource, 10); });
+        });
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    runner.run("create_destroy/std_allocator", [](std::size_t n) {
+        create_and_consume(n, [] { return single_default(); });
+    });
+    create_destroy<heap>(runner, "new_delete_resource");
+    create_destroy<std::pmr::synchronized_pool_resource>(runner, "synchronized_pool_resource");
+    create_destroy<std::pmr::unsynchronized_pool_resource>(runner, "unsynchronized_pool_resource");
+    create_destroy<std::pmr::monotonic_buffer_resource>(runner, "monotonic_buffer_resource");
+    create_destroy<generator_frame_resource>(runner, "generator_frame_resource");
+
+    runner.run("recursive_tree/std_allocator", [](std::size_t n) {
+        create_and_consume((n + 2046) / 2047, [] { return tree_default(10); });
+    });
+    recursive_tree<heap>(runner, "new_delete_resource");
+    recursive_tree<std::pmr::synchronized_pool_resource>(runner, "synchronized_pool_resource");
+    recursive_tree<std::pmr::unsynchronized_pool_resource>(runner, "unsynchronized_pool_resource");
+    recursive_tree<std::pmr::monotonic_buffer_resource>(runner, "monotonic_buffer_resource");
+    recursive_tree<generator_frame_resource>(runner, "generator_frame_resource");
+
+    return runner.report();
+}
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+//
+// Cost of generator tracing. This executable is compiled with tracing, and
+// each workload runs with recording switched off and on. Compare the "off"
+// numbers with the matching generator_benchmark results to see the cost of
+// compiling tracing in.
+//
+#define STDGENERATOR_TRACING
+
+#include <generator>
+#include <experimental/generator_trace>
+#include <cstddef>
+#include <string>
+
+#include "benchmark.hpp"
+
+namespace {
+
+std::generator<int> iota(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield static_cast<int>(i);
+    }
+}
+
+std::generator<int> chain(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(chain(depth - 1));
+    }
+}
+
+void iterate(std::size_t n) {
+    long long sum = 0;
+    for (int x : iota(n)) {
+        sum += x;
+    }
+    bench::do_not_optimize(sum);
+}
+
+void walk_chain(std::size_t n) {
+    constexpr int depth = 100;
+    long long sum = 0;
+    for (std::size_t i = 0; i < (n + depth) / (depth + 1); ++i) {
+        for (int x : chain(depth)) {
+            sum += x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+template <typename F>
+void run_with_and_without_tracing(bench::runner& runner, const std::string& name, F f) {
+    std::experimental::enable_generator_tracing(false);
+    runner.run(name + "/tracing_off", f);
+    std::experimental::enable_generator_tracing(true);
+    runner.run(name + "/tracing_on", f);
+    std::experimental::clear_generator_trace();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    run_with_and_without_tracing(runner, "iterate", iterate);
+    run_with_and_without_tracing(runner, "chain_depth_100", walk_chain);
+
+    return runner.report();
+}
@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/frame_pool>
+#include <experimental/lifo_arena>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "benchmark.hpp"
+
+namespace {
+
+template <typename Alloc>
+using generator_with = std::generator<int, int, Alloc>;
+
+// Binary tree walk: every node is its own nested generator frame.
+template <typename Alloc>
+generator_with<Alloc> tree(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(tree<Alloc>(depth - 1));
+        co_yield std::ranges::elements_of(tree<Alloc>(depth - 1));
+    }
+}
+
+// Linear chain of nested frames.
+template <typename Alloc>
+generator_with<Alloc> chain(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(chain<Alloc>(depth - 1));
+    }
+}
+
+template <typename Alloc>
+void walk_tree(std::size_t n) {
+    constexpr int depth = 10;
+    constexpr std::size_t nodes = (std::size_t(1) << (depth + 1)) - 1;
+    long long sum = 0;
+    for (std::size_t i = 0; i < (n + nodes - 1) / nodes; ++i) {
+        for (int x : tree<Alloc>(depth)) {
+            sum += x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+template <typename Alloc>
+void walk_chain(std::size_t n) {
+    constexpr int depth = 1000;
+    long long sum = 0;
+    for (std::size_t i = 0; i < (n + depth) / (depth + 1); ++i) {
+        for (int x : chain<Alloc>(depth)) {
+            sum += x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+using default_alloc = std::allocator<std::byte>;
+using pool_alloc = std::experimental::frame_pool_allocator<std::byte>;
+using arena_alloc = std::experimental::lifo_arena_allocator<std::byte>;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    runner.run("tree_walk/default", walk_tree<default_alloc>);
+    runner.run("tree_walk/frame_pool", walk_tree<pool_alloc>);
+    runner.run("tree_walk/lifo_arena", walk_tree<arena_alloc>);
+
+    runner.run("chain_depth_1000/default", walk_chain<default_alloc>);
+    runner.run("chain_depth_1000/frame_pool", walk_chain<pool_alloc>);
+    runner.run("chain_depth_1000/lifo_arena", walk_chain<arena_alloc>);
+
+    return runner.report();
+}
@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+//
+// Merging k sorted shards with merge() against a merge that keeps the
+// current value of each input in a std::priority_queue. Items are merged
+// values.
+//
+#include <generator>
+#include <experimental/merge>
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace {
+
+std::generator<const int&> elements(const std::vector<int>& values) {
+    for (const int& x : values) {
+        co_yield x;
+    }
+}
+
+std::generator<const int&> heap_merge(std::vector<std::generator<const int&>> gens) {
+    using iterator = std::generator<const int&>::iterator;
+    std::vector<iterator> its;
+    using head = std::pair<int, std::size_t>;
+    std::priority_queue<head, std::vector<head>, std::greater<head>> heap;
+    for (std::size_t i = 0; i < gens.size(); ++i) {
+        its.push_back(gens[i].begin());
+        if (its[i] != gens[i].end()) {
+            heap.emplace(*its[i], i);
+        }
+    }
+    while (!heap.empty()) {
+        const std::size_t i = heap.top().second;
+        heap.pop();
+        co_yield *its[i];
+        if (++its[i] != gens[i].end()) {
+            heap.emplace(*its[i], i);
+        }
+    }
+}
+
+// k shards with the values 0, 1, 2, ... dealt out round-robin.
+std::vector<std::vector<int>> shards(std::size_t k, std::size_t total) {
+    std::vector<std::vector<int>> result(k);
+    for (std::size_t i = 0; i < total; ++i) {
+        result[i % k].push_back(static_cast<int>(i));
+    }
+    return result;
+}
+
+template <typename Merge>
+void merge_shards(std::size_t n, std::size_t k, Merge merge) {
+    constexpr std::size_t total = 1 << 16;
+    const auto data = shards(k, total);
+    long long sum = 0;
+    for (std::size_t round = 0; round < (n + total - 1) / total; ++round) {
+        std::vector<std::generator<const int&>> gens;
+        for (const auto& shard : data) {
+            gens.push_back(elements(shard));
+        }
+        for (int x : merge(std::move(gens))) {
+            sum += x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+void run_both(bench::runner& runner, std::size_t k) {
+    const std::string suffix = "/k_" + std::to_string(k);
+    runner.run("priority_queue" + suffix, [=](std::size_t n) {
+        merge_shards(n, k, [](auto gens) { return heap_merge(std::move(gens)); });
+    });
+    runner.run("loser_tree" + suffix, [=](std::size_t n) {
+        merge_shards(n, k, [](auto gens) { return std::experimental::merge(std::move(gens)); });
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    run_both(runner, 2);
+    run_both(runner, 16);
+    run_both(runner, 256);
+    run_both(runner, 1024);
+
+    return runner.report();
+}
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+//
+// Reading the lines of a 32 MiB log-like file (lines of 20 to 200 bytes)
+// with std::getline in a generator and with mmap_lines(), and splitting an
+// in-memory buffer with __find_newline() and with memchr. Items are lines.
+// The file is in the page cache after the first run, so this measures the
+// per-line cost rather than the disk.
+//
+#include <generator>
+#include <experimental/mmap_lines>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct test_file {
+    fs::path path = fs::temp_directory_path() / "stdgenerator-mmap-lines-benchmark.log";
+    std::string contents;
+    std::size_t lines = 0;
+
+    test_file() {
+        std::minstd_rand rng(1);
+        while (contents.size() < (std::size_t(32) << 20)) {
+            const std::size_t length = 20 + rng() % 181;
+            for (std::size_t i = 0; i < length; ++i) {
+                contents.push_back(static_cast<char>('a' + rng() % 26));
+            }
+            contents.push_back('\n');
+            ++lines;
+        }
+        std::ofstream(path, std::ios::binary) << contents;
+    }
+
+    ~test_file() {
+        fs::remove(path);
+    }
+};
+
+const test_file& file() {
+    static const test_file f;
+    return f;
+}
+
+std::generator<const std::string&> getline_lines(fs::path path) {
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+    while (std::getline(in, line)) {
+        co_yield line;
+    }
+}
+
+template <typename Lines>
+void read_lines(std::size_t n, Lines lines) {
+    std::size_t total = 0;
+    std::size_t read = 0;
+    while (read < n) {
+        for (auto&& line : lines(file().path)) {
+            total += line.size();
+            if (++read == n) {
+                break;
+            }
+        }
+    }
+    bench::do_not_optimize(total);
+}
+
+template <typename Find>
+void split(std::size_t n, Find find) {
+    const char* const begin = file().contents.data();
+    const char* const end = begin + file().contents.size();
+    std::size_t total = 0;
+    std::size_t read = 0;
+    while (read < n) {
+        for (const char* p = begin; p != end && read < n; ++read) {
+            const char* newline = find(p, end);
+            total += static_cast<std::size_t>(newline - p);
+            p = newline == end ? end : newline + 1;
+        }
+    }
+    bench::do_not_optimize(total);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+    (void)file();
+
+    runner.run("lines/getline_generator", [](std::size_t n) { read_lines(n, getline_lines); });
+    runner.run("lines/mmap_lines", [](std::size_t n) { read_lines(n, std::experimental::mmap_lines); });
+
+    runner.run("split/memchr", [](std::size_t n) {
+        split(n, [](const char* p, const char* end) {
+            const void* found = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+            return found ? static_cast<const char*>(found) : end;
+        });
+    });
+    runner.run("split/find_newline", [](std::size_t n) {
+        split(n, std::experimental::__find_newline);
+    });
+
+    return runner.report();
+}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/parallel_for_each>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace {
+
+std::uint64_t work(std::uint64_t x, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+    }
+    return x;
+}
+
+std::generator<std::uint64_t> iota(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+std::vector<std::size_t> thread_counts() {
+    const std::size_t cores = std::thread::hardware_concurrency() == 0
+        ? 1 : std::thread::hardware_concurrency();
+    std::vector<std::size_t> counts;
+    for (std::size_t t = 1; t < cores; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(cores);
+    return counts;
+}
+
+void run_scaling(bench::runner& runner, const std::string& name, int rounds) {
+    runner.run(name + "/serial", [rounds](std::size_t n) {
+        std::uint64_t sum = 0;
+        for (std::uint64_t x : iota(n)) {
+            sum += work(x, rounds);
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    for (std::size_t threads : thread_counts()) {
+        std::experimental::thread_pool pool(threads);
+        runner.run(name + "/threads_" + std::to_string(threads), [&pool, rounds](std::size_t n) {
+            std::atomic<std::uint64_t> sum{0};
+            std::experimental::parallel_for_each(iota(n), pool, [&sum, rounds](std::uint64_t x) {
+                sum.fetch_add(work(x, rounds), std::memory_order_relaxed);
+            });
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    // Roughly 5ns, 50ns and 500ns of work per value.
+    run_scaling(runner, "light_work", 2);
+    run_scaling(runner, "medium_work", 20);
+    run_scaling(runner, "heavy_work", 200);
+
+    return runner.report();
+}
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/prefetch>
+#include <cstddef>
+#include <cstdint>
+
+#include "benchmark.hpp"
+
+namespace {
+
+// Stand-in for decoding/parsing work: 'rounds' steps of an integer hash.
+std::uint64_t work(std::uint64_t x, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+    }
+    return x;
+}
+
+std::generator<std::uint64_t> produce(std::size_t n, int rounds) {
+    for (std::size_t i = 0; i < n; ++i) {
+        co_yield work(i, rounds);
+    }
+}
+
+template <typename Gen>
+void consume(Gen&& g, int rounds) {
+    std::uint64_t sum = 0;
+    for (std::uint64_t x : g) {
+        sum += work(x, rounds);
+    }
+    bench::do_not_optimize(sum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    // Per-value overhead of the hand-over when neither side does any work.
+    runner.run("no_work/inline", [](std::size_t n) { consume(produce(n, 0), 0); });
+    runner.run("no_work/prefetch_64", [](std::size_t n) {
+        consume(std::experimental::prefetch(produce(n, 0), 64), 0);
+    });
+
+    // Both sides busy: with two cores prefetch approaches half the time.
+    runner.run("balanced_work/inline", [](std::size_t n) { consume(produce(n, 100), 100); });
+    runner.run("balanced_work/prefetch_64", [](std::size_t n) {
+        consume(std::experimental::prefetch(produce(n, 100), 64), 100);
+    });
+    runner.run("balanced_work/prefetch_1024", [](std::size_t n) {
+        consume(std::experimental::prefetch(produce(n, 100), 1024), 100);
+    });
+
+    return runner.report();
+}
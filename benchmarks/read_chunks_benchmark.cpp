@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+//
+// Reading a 64 MiB file in 256 KiB chunks and checksumming every byte,
+// with a generator that calls pread() on the consumer's thread and with
+// read_chunks(), which reads the next chunk on a helper thread while the
+// consumer checksums the current one. The file is in the page cache after
+// the first run, so reads are memory copies; with more than one core the
+// copy overlaps the checksum. Items are bytes.
+//
+#include <generator>
+#include <experimental/read_chunks>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "benchmark.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr std::size_t file_size = std::size_t(64) << 20;
+constexpr std::size_t chunk_size = std::size_t(256) << 10;
+
+struct test_file {
+    fs::path path = fs::temp_directory_path() / "stdgenerator-read-chunks-benchmark.bin";
+    int fd;
+
+    test_file() {
+        std::string contents(file_size, '\0');
+        for (std::size_t i = 0; i < file_size; ++i) {
+            contents[i] = static_cast<char>(i * 2654435761u >> 24);
+        }
+        std::ofstream(path, std::ios::binary) << contents;
+        fd = ::open(path.c_str(), O_RDONLY);
+    }
+
+    ~test_file() {
+        ::close(fd);
+        fs::remove(path);
+    }
+};
+
+const test_file& file() {
+    static const test_file f;
+    return f;
+}
+
+std::generator<std::span<const std::byte>> pread_chunks(int fd, std::size_t size) {
+    std::unique_ptr<std::byte[]> buffer(new std::byte[size]);
+    for (off_t offset = 0;; offset += static_cast<off_t>(size)) {
+        const ssize_t n = ::pread(fd, buffer.get(), size, offset);
+        if (n <= 0) {
+            break;
+        }
+        co_yield std::span<const std::byte>(buffer.get(), static_cast<std::size_t>(n));
+    }
+}
+
+template <typename Chunks>
+void checksum(std::size_t n, Chunks chunks) {
+    std::uint64_t sum = 0;
+    std::size_t done = 0;
+    while (done < n) {
+        for (std::span<const std::byte> chunk : chunks(file().fd, chunk_size)) {
+            for (std::byte b : chunk) {
+                sum = sum * 31 + static_cast<std::uint8_t>(b);
+            }
+            done += chunk.size();
+            if (done >= n) {
+                break;
+            }
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+    (void)file();
+
+    runner.run("checksum/pread_on_consumer", [](std::size_t n) { checksum(n, pread_chunks); });
+    runner.run("checksum/read_chunks", [](std::size_t n) { checksum(n, std::experimental::read_chunks); });
+
+    return runner.report();
+}
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+//
+// Intersection of sorted generators, with inputs that serve skip_to() by
+// galloping (sorted_elements) and inputs that do not seek and are stepped
+// through one value at a time. Items are elements of the larger input.
+//
+#include <generator>
+#include <experimental/set_operations>
+#include <cstddef>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace {
+
+using std::experimental::set_intersection;
+using std::experimental::sorted_elements;
+
+constexpr int list_size = 1 << 16;
+
+std::vector<int> every(int stride) {
+    std::vector<int> values;
+    for (int i = 0; i < list_size; i += stride) {
+        values.push_back(i);
+    }
+    return values;
+}
+
+// Yields a sorted list without handling seek requests.
+std::generator<const int&> linear_elements(const std::vector<int>& values) {
+    for (const int& x : values) {
+        co_yield x;
+    }
+}
+
+template <typename Input>
+void intersect(std::size_t n, int stride, Input input) {
+    const std::vector<int> dense = every(1);
+    const std::vector<int> other = every(stride);
+    long long sum = 0;
+    for (std::size_t i = 0; i < (n + list_size - 1) / list_size; ++i) {
+        for (int x : set_intersection(input(dense), input(other))) {
+            sum += x;
+        }
+    }
+    bench::do_not_optimize(sum);
+}
+
+void run_both(bench::runner& runner, const char* name, int stride) {
+    runner.run(std::string(name) + "/linear", [=](std::size_t n) {
+        intersect(n, stride, [](const std::vector<int>& v) { return linear_elements(v); });
+    });
+    runner.run(std::string(name) + "/galloping", [=](std::size_t n) {
+        intersect(n, stride, [](const std::vector<int>& v) { return sorted_elements(v); });
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::runner runner(argc, argv);
+
+    run_both(runner, "intersect/dense", 2);
+    run_both(runner, "intersect/sparse_1_in_64", 64);
+    run_both(runner, "intersect/sparse_1_in_4096", 4096);
+
+    return runner.report();
+}
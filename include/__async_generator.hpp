@@ -0,0 +1,286 @@
+#ifndef __STD_ASYNC_GENERATOR_INCLUDED
+#define __STD_ASYNC_GENERATOR_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// async_generator<Ref, Value, Alloc>: a generator whose producer may
+// co_await.
+//
+// The consumer is itself a coroutine and pulls values with
+//
+//     auto it = gen.begin();
+//     while (co_await it.next()) {
+//         use(*it);
+//     }
+//
+// co_await it.next() resumes the producer. The producer runs until it
+// yields a value or completes, then transfers control straight back to
+// the consumer. While the producer is suspended on some other awaitable
+// the consumer stays suspended in next(), and whichever execution context
+// resumes the producer (an event loop, an I/O completion, ...) ends up
+// resuming the consumer once a value is available.
+//
+// Nesting via co_yield std::ranges::elements_of(...) is std::generator's
+// root/leaf scheme (__generator_nesting), so yielding a value from a deeply
+// nested async_generator is still a single symmetric transfer.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace std::experimental {
+
+template <typename _Ref, typename _Value = std::remove_cvref_t<_Ref>,
+          typename _Alloc = std::allocator<std::byte>>
+class async_generator;
+
+template <typename _Ref>
+struct __async_generator_promise_base
+    : __generator_nesting<__async_generator_promise_base<_Ref>> {
+    template <typename _Ref2, typename _Value, typename _Alloc>
+    friend class async_generator;
+
+    using __nesting = __generator_nesting<__async_generator_promise_base>;
+    using __nesting::__root_;
+
+    template <typename _Gen>
+    using __yield_sequence_awaiter = typename __nesting::template __yield_sequence_awaiter<_Gen>;
+
+    // Coroutine suspended in next(). Only used on the root.
+    std::coroutine_handle<> __consumer_;
+    // Exception thrown by this coroutine. Rethrown in the parent of a
+    // nested coroutine, or from next() for the root.
+    std::exception_ptr __exception_;
+    __manual_lifetime<_Ref> __value_;
+    bool __has_value_ = false;
+
+    explicit __async_generator_promise_base(std::coroutine_handle<> __thisCoro) noexcept
+        : __nesting(this, __thisCoro)
+    {}
+
+    ~__async_generator_promise_base() {
+        __clear();
+    }
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+        __exception_ = std::current_exception();
+    }
+
+    void __on_nest(__async_generator_promise_base&, std::coroutine_handle<>) noexcept {}
+
+    void __on_unnest(std::coroutine_handle<>) noexcept {}
+
+    void __rethrow_if_failed() {
+        if (__exception_) {
+            std::rethrow_exception(std::move(__exception_));
+        }
+    }
+
+    // Once the root completes, the consumer waiting in next() resumes.
+    std::coroutine_handle<> __root_continuation() noexcept {
+        return __consumer_;
+    }
+
+    // Transfers control to the consumer waiting for the yielded value.
+    struct __yield_awaiter {
+        __async_generator_promise_base* __root_;
+
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept {
+            return __root_->__consumer_;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    __yield_awaiter yield_value(_Ref&& __x)
+            noexcept(std::is_nothrow_move_constructible_v<_Ref>) {
+        __root_->__value_.construct((_Ref&&)__x);
+        __root_->__has_value_ = true;
+        return {__root_};
+    }
+
+    template <typename _T>
+    requires
+        (!std::is_reference_v<_Ref>) &&
+        std::is_convertible_v<_T, _Ref>
+    __yield_awaiter yield_value(_T&& __x)
+            noexcept(std::is_nothrow_constructible_v<_Ref, _T>) {
+        __root_->__value_.construct((_T&&)__x);
+        __root_->__has_value_ = true;
+        return {__root_};
+    }
+
+    template <typename _OValue, typename _OAlloc>
+    __yield_sequence_awaiter<async_generator<_Ref, _OValue, _OAlloc>>
+    yield_value(std::ranges::elements_of<async_generator<_Ref, _OValue, _OAlloc>> __g) noexcept {
+        return std::move(__g).get();
+    }
+
+    void __clear() noexcept {
+        if (__has_value_) {
+            __value_.destruct();
+            __has_value_ = false;
+        }
+    }
+};
+
+template <typename _Ref, typename _Value, typename _Alloc>
+struct __async_generator_promise final
+    : public __async_generator_promise_base<_Ref>
+    , public __promise_base_alloc<__byte_allocator_t<_Alloc>> {
+    __async_generator_promise() noexcept
+        : __async_generator_promise_base<_Ref>(
+              std::coroutine_handle<__async_generator_promise>::from_promise(*this))
+    {
+        __generator_frames::__discard_allocation();
+    }
+
+    async_generator<_Ref, _Value, _Alloc> get_return_object() noexcept {
+        return async_generator<_Ref, _Value, _Alloc>{
+            std::coroutine_handle<__async_generator_promise>::from_promise(*this)
+        };
+    }
+
+    using __async_generator_promise_base<_Ref>::yield_value;
+
+    template <std::ranges::range _Rng>
+    typename __async_generator_promise_base<_Ref>::template __yield_sequence_awaiter<async_generator<_Ref, _Value, _Alloc>>
+    yield_value(std::ranges::elements_of<_Rng> && __x) {
+        return [](auto && __rng) -> async_generator<_Ref, _Value, _Alloc> {
+            for(auto && e: __rng)
+                co_yield static_cast<decltype(e)>(e);
+        }(std::forward<_Rng>(__x.get()));
+    }
+};
+
+template <typename _Ref, typename _Value, typename _Alloc>
+class async_generator {
+public:
+    using promise_type = __async_generator_promise<_Ref, _Value, _Alloc>;
+    friend promise_type;
+private:
+    using __coroutine_handle = std::coroutine_handle<promise_type>;
+public:
+
+    async_generator() noexcept = default;
+
+    async_generator(async_generator&& __other) noexcept
+        : __coro_(std::exchange(__other.__coro_, {})) {
+    }
+
+    // Must not be destroyed while a consumer is suspended in next().
+    ~async_generator() noexcept {
+        if (__coro_) {
+            __coro_.destroy();
+        }
+    }
+
+    async_generator& operator=(async_generator&& __g) noexcept {
+        swap(__g);
+        return *this;
+    }
+
+    void swap(async_generator& __other) noexcept {
+        std::swap(__coro_, __other.__coro_);
+    }
+
+    class iterator {
+      public:
+        using value_type = _Value;
+        using reference = _Ref;
+        using pointer = std::add_pointer_t<_Ref>;
+
+        iterator() noexcept = default;
+        iterator(const iterator &) = delete;
+
+        iterator(iterator&& __other) noexcept
+        : __coro_(std::exchange(__other.__coro_, {})) {
+        }
+
+        iterator& operator=(iterator&& __other) {
+            std::swap(__coro_, __other.__coro_);
+            return *this;
+        }
+
+        struct __next_awaiter {
+            __coroutine_handle __coro_;
+
+            bool await_ready() noexcept {
+                return __coro_.done();
+            }
+
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<> __consumer) noexcept {
+                auto& __promise = __coro_.promise();
+                __promise.__clear();
+                __promise.__consumer_ = __consumer;
+                return __promise.__parentOrLeaf_;
+            }
+
+            bool await_resume() {
+                auto& __promise = __coro_.promise();
+                if (__promise.__exception_) {
+                    std::rethrow_exception(std::exchange(__promise.__exception_, nullptr));
+                }
+                return !__coro_.done();
+            }
+        };
+
+        // Awaits the next value. Evaluates to false once the producer has
+        // completed; rethrows any exception that escaped the producer.
+        __next_awaiter next() noexcept {
+            return __next_awaiter{__coro_};
+        }
+
+        reference operator*() const noexcept {
+            return static_cast<reference>(__coro_.promise().__value_.get());
+        }
+
+      private:
+        friend async_generator;
+
+        explicit iterator(__coroutine_handle __coro) noexcept
+        : __coro_(__coro) {}
+
+        __coroutine_handle __coro_;
+    };
+
+    // Does not start the producer; the first call to next() does.
+    iterator begin() noexcept {
+        assert(__coro_);
+        return iterator{__coro_};
+    }
+
+private:
+    explicit async_generator(__coroutine_handle __coro) noexcept
+        : __coro_(__coro) {
+    }
+
+public: // to get around access restrictions for __yield_sequence_awaitable
+    std::coroutine_handle<> __get_coro() noexcept { return __coro_; }
+    promise_type* __get_promise() noexcept { return std::addressof(__coro_.promise()); }
+
+private:
+    __coroutine_handle __coro_;
+};
+
+} // namespace std::experimental
+
+#endif // __STD_ASYNC_GENERATOR_INCLUDED
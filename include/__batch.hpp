@@ -0,0 +1,151 @@
+#ifndef __STD_BATCH_INCLUDED
+#define __STD_BATCH_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// Block-wise consumption of generators of scalar values.
+//
+// batch(gen, n) yields the values of gen as std::span<const T> blocks of n
+// values, the last of which may be shorter. for_each_batch(gen, n, kernel)
+// calls kernel with such blocks directly, without a generator in between.
+// unbatch(gen) does the reverse, turning a generator of contiguous blocks
+// back into a generator of their elements.
+//
+// Blocks are gathered into a buffer aligned to batch_alignment bytes that
+// is allocated once and reused, so a kernel can process a block with a
+// loop the compiler vectorises instead of a value-at-a-time iterator loop.
+// for_each_batch() also rounds n up to a whole number of
+// batch_alignment-byte vectors, so every block but the last is made of
+// whole aligned vectors and only the last has a scalar tail.
+//
+// Blocks are filled without going through the iterator; a contiguous range
+// that the producer yields via elements_of() is copied in one go.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+
+namespace std::experimental {
+
+// Alignment of the blocks produced by batch() and for_each_batch(), which
+// is the width of the widest x86 vector registers.
+inline constexpr std::size_t batch_alignment = 64;
+
+// Storage for __size value-initialised _Ts aligned to batch_alignment.
+template <typename _T>
+class __aligned_buffer {
+public:
+    static constexpr std::align_val_t __alignment{std::max(batch_alignment, alignof(_T))};
+
+    explicit __aligned_buffer(std::size_t __size)
+        : __data_(static_cast<_T*>(::operator new(__size * sizeof(_T), __alignment)))
+        , __size_(__size) {
+        try {
+            std::uninitialized_value_construct_n(__data_, __size);
+        } catch (...) {
+            ::operator delete(__data_, __alignment);
+            throw;
+        }
+    }
+
+    __aligned_buffer(const __aligned_buffer&) = delete;
+    __aligned_buffer& operator=(const __aligned_buffer&) = delete;
+
+    ~__aligned_buffer() {
+        std::destroy_n(__data_, __size_);
+        ::operator delete(__data_, __alignment);
+    }
+
+    _T* __data() const noexcept {
+        return __data_;
+    }
+
+private:
+    _T* __data_;
+    std::size_t __size_;
+};
+
+// Rounds __n up to a whole number of batch_alignment-byte vectors of _T.
+template <typename _T>
+constexpr std::size_t __round_to_vectors(std::size_t __n) noexcept {
+    __n = std::max<std::size_t>(__n, 1);
+    if constexpr (batch_alignment % sizeof(_T) == 0) {
+        constexpr std::size_t __lanes = batch_alignment / sizeof(_T);
+        return (__n + __lanes - 1) / __lanes * __lanes;
+    } else {
+        return __n;
+    }
+}
+
+// Yields the values of __gen in blocks of __n, the last of which may be
+// shorter. A block is valid until the next one is requested.
+template <typename _Ref, typename _Value, typename _Alloc>
+    requires std::default_initializable<_Value>
+std::generator<std::span<const _Value>> batch(std::generator<_Ref, _Value, _Alloc> __gen,
+                                              std::size_t __n) {
+    __n = std::max<std::size_t>(__n, 1);
+    __aligned_buffer<_Value> __buffer(__n);
+    for (;;) {
+        const std::size_t __count = __gen.__fill(__buffer.__data(), __n);
+        if (__count == 0) {
+            break;
+        }
+        co_yield std::span<const _Value>(__buffer.__data(), __count);
+        if (__count != __n) {
+            break;
+        }
+    }
+}
+
+// Yields the elements of each block yielded by __batches.
+template <typename _Ref, typename _Value, typename _Alloc>
+    requires std::ranges::contiguous_range<std::remove_cvref_t<_Ref>>
+std::generator<const std::ranges::range_value_t<std::remove_cvref_t<_Ref>>&,
+               std::ranges::range_value_t<std::remove_cvref_t<_Ref>>>
+unbatch(std::generator<_Ref, _Value, _Alloc> __batches) {
+    for (auto&& __block : __batches) {
+        // Handed to the consumer without resuming this coroutine per value.
+        co_yield std::ranges::elements_of(__block);
+    }
+}
+
+// Calls __kernel with successive blocks of the values of __gen, as
+// std::span<const _Value>. __block is rounded up to a whole number of
+// batch_alignment-byte vectors; every block starts on a batch_alignment
+// boundary and all but the last are full.
+template <typename _Ref, typename _Value, typename _Alloc, typename _Kernel>
+    requires std::default_initializable<_Value> &&
+             std::invocable<_Kernel&, std::span<const _Value>>
+void for_each_batch(std::generator<_Ref, _Value, _Alloc>&& __gen, std::size_t __block,
+                    _Kernel __kernel) {
+    const std::size_t __n = __round_to_vectors<_Value>(__block);
+    __aligned_buffer<_Value> __buffer(__n);
+    for (;;) {
+        const std::size_t __count = __gen.__fill(__buffer.__data(), __n);
+        if (__count == 0) {
+            break;
+        }
+        std::invoke(__kernel, std::span<const _Value>(__buffer.__data(), __count));
+        if (__count != __n) {
+            break;
+        }
+    }
+}
+
+} // namespace std::experimental
+
+#endif // __STD_BATCH_INCLUDED
@@ -0,0 +1,332 @@
+#ifndef __STD_BUFFERED_GENERATOR_INCLUDED
+#define __STD_BUFFERED_GENERATOR_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// buffered_generator<T, N>: a generator that produces up to N values per
+// suspension.
+//
+// The consumer's iterator holds a fixed buffer of N values. co_yield appends
+// to the buffer and only suspends the producer once the buffer is full. The
+// iterator drains the buffer without resuming the producer and resumes it
+// once the buffer is empty, so for small value types the cost of a
+// coroutine switch is amortised over N elements. Buffered values live until
+// they are consumed and the buffer is refilled, or the iterator is
+// destroyed. Frames, nested or not, hold no buffer.
+//
+// Producer code is written exactly as for std::generator and may nest other
+// buffered generators of the same element type and buffer size, or ranges,
+// with co_yield std::ranges::elements_of(...).
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace std::experimental {
+
+template <typename _T, std::size_t _N = 64, typename _Alloc = std::allocator<std::byte>>
+class buffered_generator;
+
+template <typename _T, std::size_t _N>
+struct __buffered_generator_promise_base
+    : __generator_nesting<__buffered_generator_promise_base<_T, _N>> {
+    static_assert(!std::is_reference_v<_T>, "buffered_generator requires a value type");
+    static_assert(_N > 0, "buffered_generator requires a non-empty buffer");
+
+    template <typename _T2, std::size_t _N2, typename _Alloc>
+    friend class buffered_generator;
+
+    using __nesting = __generator_nesting<__buffered_generator_promise_base>;
+    using __nesting::__root_;
+    using __nesting::__parentOrLeaf_;
+
+    template <typename _Gen>
+    using __yield_sequence_awaiter = typename __nesting::template __yield_sequence_awaiter<_Gen>;
+
+    // Exception thrown by this coroutine. For a nested coroutine it is
+    // rethrown in the parent; for the root it is rethrown to the consumer
+    // once the values buffered before it have been consumed.
+    std::exception_ptr __exception_;
+
+    // Buffer of the iterator consuming the root, so that nested frames do
+    // not carry one. Values [0, __size_) of it are constructed. Only used
+    // on the root.
+    __manual_lifetime<_T>* __buffer_ = nullptr;
+    std::size_t __size_ = 0;
+
+    explicit __buffered_generator_promise_base(std::coroutine_handle<> __thisCoro) noexcept
+        : __nesting(this, __thisCoro)
+    {}
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+        __exception_ = std::current_exception();
+    }
+
+    void __on_nest(__buffered_generator_promise_base&, std::coroutine_handle<>) noexcept {}
+
+    void __on_unnest(std::coroutine_handle<>) noexcept {}
+
+    void __rethrow_if_failed() {
+        if (__exception_) {
+            std::rethrow_exception(std::move(__exception_));
+        }
+    }
+
+    std::coroutine_handle<> __root_continuation() noexcept {
+        return std::noop_coroutine();
+    }
+
+    // Only suspends the producer once the root's buffer is full.
+    struct __yield_awaiter {
+        bool __full_;
+
+        bool await_ready() noexcept {
+            return !__full_;
+        }
+
+        void await_suspend(std::coroutine_handle<>) noexcept {}
+
+        void await_resume() noexcept {}
+    };
+
+    __yield_awaiter yield_value(_T&& __x)
+            noexcept(std::is_nothrow_move_constructible_v<_T>) {
+        __buffered_generator_promise_base& __root = *__root_;
+        __root.__buffer_[__root.__size_].construct(std::move(__x));
+        return {++__root.__size_ == _N};
+    }
+
+    __yield_awaiter yield_value(const _T& __x)
+            noexcept(std::is_nothrow_copy_constructible_v<_T>) {
+        __buffered_generator_promise_base& __root = *__root_;
+        __root.__buffer_[__root.__size_].construct(__x);
+        return {++__root.__size_ == _N};
+    }
+
+    template <typename _OAlloc>
+    __yield_sequence_awaiter<buffered_generator<_T, _N, _OAlloc>>
+    yield_value(std::ranges::elements_of<buffered_generator<_T, _N, _OAlloc>> __g) noexcept {
+        return std::move(__g).get();
+    }
+
+    // Resume the producer until it fills __buffer, which holds no values, or
+    // completes. Rethrows the root's exception once all buffered values are
+    // consumed.
+    void __refill(std::coroutine_handle<> __rootCoro, __manual_lifetime<_T>* __buffer) {
+        __buffer_ = __buffer;
+        __size_ = 0;
+        if (!__rootCoro.done()) {
+            __parentOrLeaf_.resume();
+        }
+        if (__size_ == 0 && __exception_) {
+            std::rethrow_exception(std::exchange(__exception_, nullptr));
+        }
+    }
+
+    // Disable use of co_await within this coroutine.
+    void await_transform() = delete;
+};
+
+template <typename _T, std::size_t _N, typename _Alloc>
+struct __buffered_generator_promise final
+    : public __buffered_generator_promise_base<_T, _N>
+    , public __promise_base_alloc<__byte_allocator_t<_Alloc>> {
+    __buffered_generator_promise() noexcept
+        : __buffered_generator_promise_base<_T, _N>(
+              std::coroutine_handle<__buffered_generator_promise>::from_promise(*this))
+    {
+        __generator_frames::__discard_allocation();
+    }
+
+    buffered_generator<_T, _N, _Alloc> get_return_object() noexcept {
+        return buffered_generator<_T, _N, _Alloc>{
+            std::coroutine_handle<__buffered_generator_promise>::from_promise(*this)
+        };
+    }
+
+    using __buffered_generator_promise_base<_T, _N>::yield_value;
+
+    template <std::ranges::range _Rng>
+    typename __buffered_generator_promise_base<_T, _N>::template __yield_sequence_awaiter<buffered_generator<_T, _N, _Alloc>>
+    yield_value(std::ranges::elements_of<_Rng> && __x) {
+        return [](auto && __rng) -> buffered_generator<_T, _N, _Alloc> {
+            for(auto && e: __rng)
+                co_yield static_cast<decltype(e)>(e);
+        }(std::forward<_Rng>(__x.get()));
+    }
+};
+
+template <typename _T, std::size_t _N, typename _Alloc>
+class buffered_generator {
+public:
+    using promise_type = __buffered_generator_promise<_T, _N, _Alloc>;
+    friend promise_type;
+private:
+    using __coroutine_handle = std::coroutine_handle<promise_type>;
+public:
+
+    buffered_generator() noexcept = default;
+
+    buffered_generator(buffered_generator&& __other) noexcept
+        : __coro_(std::exchange(__other.__coro_, {}))
+        , __started_(std::exchange(__other.__started_, false)) {
+    }
+
+    ~buffered_generator() noexcept {
+        if (__coro_) {
+            __coro_.destroy();
+        }
+    }
+
+    buffered_generator& operator=(buffered_generator&& __g) noexcept {
+        swap(__g);
+        return *this;
+    }
+
+    void swap(buffered_generator& __other) noexcept {
+        std::swap(__coro_, __other.__coro_);
+        std::swap(__started_, __other.__started_);
+    }
+
+    struct sentinel {};
+
+    // Holds the buffer that the root's producer fills, and destroys the
+    // values in it.
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = _T;
+        using reference = _T&;
+        using pointer = _T*;
+
+        iterator() noexcept = default;
+        iterator(const iterator &) = delete;
+
+        iterator(iterator&& __other) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+            __take(__other);
+        }
+
+        iterator& operator=(iterator&& __other) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+            if (this != &__other) {
+                __clear();
+                __take(__other);
+            }
+            return *this;
+        }
+
+        ~iterator() {
+            __clear();
+        }
+
+        friend bool operator==(const iterator &it, sentinel) noexcept {
+            return it.__cur_ == it.__size_;
+        }
+
+        iterator &operator++() {
+            if (++__cur_ == __size_) {
+                __refill();
+            }
+            return *this;
+        }
+
+        void operator++(int) {
+            (void)operator++();
+        }
+
+        reference operator*() const noexcept {
+            return __buffer_[__cur_].get();
+        }
+
+      private:
+        friend buffered_generator;
+
+        explicit iterator(__coroutine_handle __coro)
+        : __coro_(__coro) {
+            __refill();
+        }
+
+        // Destroys the buffered values and has the producer produce more.
+        void __refill() {
+            __clear();
+            auto& __promise = __coro_.promise();
+            typename promise_type::__resume_guard __guard{__promise};
+            __promise.__refill(__coro_, __buffer_);
+            __size_ = __promise.__size_;
+        }
+
+        void __clear() noexcept {
+            for (std::size_t __i = 0; __i != __size_; ++__i) {
+                __buffer_[__i].destruct();
+            }
+            __cur_ = __size_ = 0;
+        }
+
+        // Moves the unconsumed values of __other, and the producer with
+        // them, to this iterator. __other is left empty.
+        void __take(iterator& __other) noexcept(std::is_nothrow_move_constructible_v<_T>) {
+            for (std::size_t __i = __other.__cur_; __i != __other.__size_; ++__i) {
+                __buffer_[__size_++].construct(std::move(__other.__buffer_[__i].get()));
+            }
+            __other.__clear();
+            __coro_ = std::exchange(__other.__coro_, {});
+        }
+
+        __coroutine_handle __coro_;
+        // Values [0, __size_) are constructed; [__cur_, __size_) are yet
+        // to be consumed.
+        std::size_t __cur_ = 0;
+        std::size_t __size_ = 0;
+        mutable __manual_lifetime<_T> __buffer_[_N];
+    };
+
+    iterator begin() {
+        assert(__coro_);
+        assert(!__started_);
+        __started_ = true;
+        return iterator{__coro_};
+    }
+
+    sentinel end() noexcept {
+        return {};
+    }
+
+private:
+    explicit buffered_generator(__coroutine_handle __coro) noexcept
+        : __coro_(__coro) {
+    }
+
+public: // to get around access restrictions for __yield_sequence_awaitable
+    std::coroutine_handle<> __get_coro() noexcept { return __coro_; }
+    promise_type* __get_promise() noexcept { return std::addressof(__coro_.promise()); }
+
+private:
+    __coroutine_handle __coro_;
+    bool __started_ = false;
+};
+
+} // namespace std::experimental
+
+#if __has_include(<ranges>)
+namespace std::ranges {
+
+template <typename _T, std::size_t _N, typename _Alloc>
+constexpr inline bool enable_view<experimental::buffered_generator<_T, _N, _Alloc>> = true;
+
+} // namespace std::ranges
+#endif
+
+#endif // __STD_BUFFERED_GENERATOR_INCLUDED
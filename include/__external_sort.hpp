@@ -0,0 +1,443 @@
+#ifndef __STD_EXTERNAL_SORT_INCLUDED
+#define __STD_EXTERNAL_SORT_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// external_sort(gen, memory_budget, tmpdir): sorts the values of a
+// generator that may not fit in memory.
+//
+// Values are collected into a run of at most memory_budget bytes, counted
+// as sizeof(T) per value. A full run is split into slices that are sorted
+// concurrently on a thread_pool, and the sorted slices are merged in memory
+// and written as one run to a temporary file in tmpdir. Once the input is
+// exhausted the runs are merged back with merge() and yielded lazily. If
+// there are too many runs to give each a read buffer of a useful size
+// within the budget, or to keep each open at once, groups of them are first
+// merged into longer runs on disk. Input that fits in a single run is
+// sorted and merged in memory and never touches the disk.
+//
+// Every spill file is written and read sequentially, in blocks of at least
+// __min_io_buffer bytes, and removed as soon as it has been merged or the
+// returned generator is destroyed.
+//
+// Trivially copyable values are stored as their object representation.
+// Other types are supported by specialising spill_traits with
+//
+//   static void write(std::FILE*, const T&);
+//   static T read(std::FILE*);
+//
+// The sort is not stable. I/O errors are reported as std::system_error.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+#include <__merge.hpp>
+#include <__thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace std::experimental {
+
+// Specialise to let external_sort() spill values of a type that is not
+// trivially copyable.
+template <typename _T>
+struct spill_traits;
+
+template <typename _T>
+concept __spillable =
+    std::is_trivially_copyable_v<_T> ||
+    requires(std::FILE* __file, const _T& __value) {
+        spill_traits<_T>::write(__file, __value);
+        { spill_traits<_T>::read(__file) } -> std::same_as<_T>;
+    };
+
+[[noreturn]] inline void __throw_spill_error(const char* __what, int __error = errno) {
+    // Stream functions need not set errno, so never report success.
+    throw std::system_error(__error != 0 ? __error : EIO, std::generic_category(), __what);
+}
+
+// Reports a read from __file that returned fewer values than asked for.
+[[noreturn]] inline void __throw_short_read(std::FILE* __file) {
+    if (std::feof(__file)) {
+        __throw_spill_error("external_sort: spill file is truncated", EIO);
+    }
+    __throw_spill_error("external_sort: cannot read spill file");
+}
+
+struct __file_closer {
+    void operator()(std::FILE* __file) const noexcept {
+        std::fclose(__file);
+    }
+};
+
+using __unique_file = std::unique_ptr<std::FILE, __file_closer>;
+
+// A temporary file holding one run, removed when the run is released.
+class __spill_file {
+public:
+    explicit __spill_file(const std::filesystem::path& __dir) {
+        static std::atomic<std::uint64_t> __counter{0};
+        static const std::uint64_t __prefix = std::random_device{}();
+        for (int __attempt = 0; __attempt != 100; ++__attempt) {
+            __path_ = __dir / ("stdgenerator-sort-" + std::to_string(__prefix) + "-" +
+                               std::to_string(__counter.fetch_add(1)) + ".run");
+            // "x" fails rather than truncating a file that already exists.
+            __writer_.reset(std::fopen(__path_.c_str(), "wbx"));
+            if (__writer_ || errno != EEXIST) {
+                break;
+            }
+        }
+        if (!__writer_) {
+            __throw_spill_error("external_sort: cannot create spill file");
+        }
+    }
+
+    __spill_file(const __spill_file&) = delete;
+    __spill_file& operator=(const __spill_file&) = delete;
+
+    ~__spill_file() {
+        __writer_.reset();
+        std::error_code __ec;
+        std::filesystem::remove(__path_, __ec);
+    }
+
+    std::FILE* __writer() const noexcept {
+        return __writer_.get();
+    }
+
+    // Flushes and closes the writer; the file can then be read.
+    void __seal() {
+        if (std::fclose(__writer_.release()) != 0) {
+            __throw_spill_error("external_sort: cannot write spill file");
+        }
+    }
+
+    __unique_file __open_reader() const {
+        __unique_file __reader(std::fopen(__path_.c_str(), "rb"));
+        if (!__reader) {
+            __throw_spill_error("external_sort: cannot read spill file");
+        }
+        return __reader;
+    }
+
+private:
+    std::filesystem::path __path_;
+    __unique_file __writer_;
+};
+
+// A sorted sequence of __count values stored in __file_.
+struct __spill_run {
+    std::shared_ptr<__spill_file> __file_;
+    std::size_t __count_;
+};
+
+inline constexpr std::size_t __min_io_buffer = 64 * 1024;
+
+// Most runs merged at once, each holding a file open.
+inline constexpr std::size_t __max_fan_in = 256;
+
+template <typename _T>
+void __write_values(std::FILE* __file, const _T* __values, std::size_t __count) {
+    if constexpr (std::is_trivially_copyable_v<_T>) {
+        if (std::fwrite(__values, sizeof(_T), __count, __file) != __count) {
+            __throw_spill_error("external_sort: cannot write spill file");
+        }
+    } else {
+        for (std::size_t __i = 0; __i != __count; ++__i) {
+            spill_traits<_T>::write(__file, __values[__i]);
+        }
+        if (std::ferror(__file)) {
+            __throw_spill_error("external_sort: cannot write spill file");
+        }
+    }
+}
+
+// Yields the values of __run, reading __buffer_bytes at a time.
+template <typename _T>
+std::generator<_T> __read_run(__spill_run __run, std::size_t __buffer_bytes) {
+    if constexpr (std::is_trivially_copyable_v<_T>) {
+        // Raw bytes, as _T need not be default constructible. Each value is
+        // copied out of them into __value before it is yielded.
+        const std::size_t __capacity =
+            std::min(std::max<std::size_t>(1, __buffer_bytes / sizeof(_T)), __run.__count_);
+        std::unique_ptr<std::byte[]> __buffer(new std::byte[__capacity * sizeof(_T)]);
+        __manual_lifetime<_T> __value;
+        __unique_file __reader = __run.__file_->__open_reader();
+        std::setvbuf(__reader.get(), nullptr, _IONBF, 0);
+        for (std::size_t __left = __run.__count_; __left != 0;) {
+            const std::size_t __n = std::min(__left, __capacity);
+            if (std::fread(__buffer.get(), sizeof(_T), __n, __reader.get()) != __n) {
+                __throw_short_read(__reader.get());
+            }
+            for (std::size_t __i = 0; __i != __n; ++__i) {
+                std::memcpy(static_cast<void*>(std::addressof(__value)),
+                            __buffer.get() + __i * sizeof(_T), sizeof(_T));
+                co_yield __value.get();
+            }
+            __left -= __n;
+        }
+    } else {
+        // Declared first so that it outlives the stream using it.
+        std::unique_ptr<char[]> __buffer(new char[__buffer_bytes]);
+        __unique_file __reader = __run.__file_->__open_reader();
+        std::setvbuf(__reader.get(), __buffer.get(), _IOFBF, __buffer_bytes);
+        for (std::size_t __left = __run.__count_; __left != 0; --__left) {
+            // Checked before yielding, so that a value read from a failed
+            // stream is never passed on.
+            _T __value = spill_traits<_T>::read(__reader.get());
+            if (std::ferror(__reader.get())) {
+                __throw_spill_error("external_sort: cannot read spill file");
+            }
+            co_yield std::move(__value);
+        }
+    }
+}
+
+// Sorts __values in slices of at least __min_slice values, concurrently on
+// __pool and the calling thread, and returns the slice boundaries.
+template <typename _T>
+std::vector<std::size_t> __sort_slices(std::vector<_T>& __values, thread_pool* __pool) {
+    constexpr std::size_t __min_slice = 16 * 1024;
+    const std::size_t __n = __values.size();
+    std::size_t __slices = __pool == nullptr ? 1 : __pool->size() + 1;
+    __slices = std::max<std::size_t>(1, std::min(__slices, __n / __min_slice));
+
+    std::vector<std::size_t> __bounds(__slices + 1);
+    for (std::size_t __i = 0; __i <= __slices; ++__i) {
+        __bounds[__i] = __n * __i / __slices;
+    }
+    auto __sort_slice = [&](std::size_t __i) {
+        std::sort(__values.begin() + __bounds[__i], __values.begin() + __bounds[__i + 1]);
+    };
+    if (__slices == 1) {
+        __sort_slice(0);
+        return __bounds;
+    }
+
+    std::vector<std::exception_ptr> __errors(__slices);
+    std::mutex __mutex;
+    std::condition_variable __done;
+    std::size_t __running = __slices - 1;
+    for (std::size_t __i = 1; __i != __slices; ++__i) {
+        __pool->submit([&, __i]() noexcept {
+            try {
+                __sort_slice(__i);
+            } catch (...) {
+                __errors[__i] = std::current_exception();
+            }
+            std::lock_guard<std::mutex> __lock(__mutex);
+            if (--__running == 0) {
+                __done.notify_one();
+            }
+        });
+    }
+    try {
+        __sort_slice(0);
+    } catch (...) {
+        __errors[0] = std::current_exception();
+    }
+    // Help with the remaining slices, then wait for those still running.
+    while (__pool->__run_pending_task()) {
+    }
+    {
+        std::unique_lock<std::mutex> __lock(__mutex);
+        __done.wait(__lock, [&] { return __running == 0; });
+    }
+    for (std::exception_ptr& __e : __errors) {
+        if (__e) {
+            std::rethrow_exception(__e);
+        }
+    }
+    return __bounds;
+}
+
+// Merges the sorted slices of __values between consecutive __bounds,
+// moving the values out.
+template <typename _T>
+std::generator<_T&&, _T> __merge_slices(std::vector<_T>& __values,
+                                        const std::vector<std::size_t>& __bounds) {
+    std::vector<std::generator<_T&&, _T>> __slices;
+    for (std::size_t __i = 0; __i + 1 < __bounds.size(); ++__i) {
+        __slices.push_back([](_T* __first, _T* __last) -> std::generator<_T&&, _T> {
+            for (; __first != __last; ++__first) {
+                co_yield std::move(*__first);
+            }
+        }(__values.data() + __bounds[__i], __values.data() + __bounds[__i + 1]));
+    }
+    return std::experimental::merge(std::move(__slices));
+}
+
+// Writes the values of __merged as one run in a new spill file, staging
+// __buffer_bytes at a time.
+template <typename _T, typename _Gen>
+__spill_run __write_run(_Gen __merged, std::size_t __buffer_bytes,
+                        const std::filesystem::path& __tmpdir) {
+    auto __file = std::make_shared<__spill_file>(__tmpdir);
+    std::vector<_T> __staged;
+    __staged.reserve(std::max<std::size_t>(1, __buffer_bytes / sizeof(_T)));
+    std::size_t __count = 0;
+    for (auto __it = __merged.begin(); __it != __merged.end(); ++__it) {
+        __staged.push_back(__it.take());
+        if (__staged.size() == __staged.capacity()) {
+            __write_values(__file->__writer(), __staged.data(), __staged.size());
+            __count += __staged.size();
+            __staged.clear();
+        }
+    }
+    __write_values(__file->__writer(), __staged.data(), __staged.size());
+    __count += __staged.size();
+    __file->__seal();
+    return __spill_run{std::move(__file), __count};
+}
+
+// Merges __runs into one run in a new spill file.
+template <typename _T>
+__spill_run __merge_runs(std::vector<__spill_run> __runs, std::size_t __memory_budget,
+                         const std::filesystem::path& __tmpdir) {
+    // One buffer per input and one for the output.
+    const std::size_t __buffer_bytes = __memory_budget / (__runs.size() + 1);
+    std::vector<std::generator<_T>> __readers;
+    for (__spill_run& __run : __runs) {
+        __readers.push_back(__read_run<_T>(std::move(__run), __buffer_bytes));
+    }
+    return std::experimental::__write_run<_T>(
+        std::experimental::merge(std::move(__readers)), __buffer_bytes, __tmpdir);
+}
+
+template <typename _Ref, typename _Value, typename _Alloc>
+std::generator<_Value> __external_sort(std::generator<_Ref, _Value, _Alloc> __gen,
+                                       std::size_t __memory_budget,
+                                       std::filesystem::path __tmpdir,
+                                       thread_pool* __pool) {
+    __memory_budget = std::max(__memory_budget, 2 * __min_io_buffer);
+    const std::size_t __run_capacity = std::max<std::size_t>(1, __memory_budget / sizeof(_Value));
+
+    // Only created once a run fills up.
+    std::optional<thread_pool> __own_pool;
+    std::vector<_Value> __run;
+    std::vector<__spill_run> __runs;
+    auto __spill = [&] {
+        if (__pool == nullptr) {
+            __pool = std::addressof(__own_pool.emplace());
+        }
+        const std::vector<std::size_t> __bounds = __sort_slices(__run, __pool);
+        if (__bounds.size() == 2) {
+            auto __file = std::make_shared<__spill_file>(__tmpdir);
+            __write_values(__file->__writer(), __run.data(), __run.size());
+            __file->__seal();
+            __runs.push_back(__spill_run{std::move(__file), __run.size()});
+        } else {
+            __runs.push_back(std::experimental::__write_run<_Value>(
+                std::experimental::__merge_slices(__run, __bounds), __min_io_buffer, __tmpdir));
+        }
+        __run.clear();
+    };
+
+    for (auto __it = __gen.begin(); __it != __gen.end(); ++__it) {
+        if (__run.size() == __run.capacity()) {
+            __run.reserve(std::min(__run_capacity, std::max<std::size_t>(16, 2 * __run.size())));
+        }
+        __run.push_back(__it.take());
+        if (__run.size() == __run_capacity) {
+            __spill();
+        }
+    }
+
+    if (__runs.empty()) {
+        const std::vector<std::size_t> __bounds = __sort_slices(__run, __pool);
+        for (_Value&& __value : std::experimental::__merge_slices(__run, __bounds)) {
+            co_yield std::move(__value);
+        }
+        co_return;
+    }
+
+    if (!__run.empty()) {
+        __spill();
+    }
+    std::vector<_Value>().swap(__run);
+
+    // Merge groups of runs on disk until each remaining run can be given a
+    // read buffer of at least __min_io_buffer bytes, and at most
+    // __max_fan_in files are open at once.
+    const std::size_t __fan_in =
+        std::clamp<std::size_t>(__memory_budget / __min_io_buffer - 1, 2, __max_fan_in);
+    while (__runs.size() > __fan_in) {
+        std::vector<__spill_run> __merged;
+        for (std::size_t __i = 0; __i < __runs.size(); __i += __fan_in) {
+            const std::size_t __end = std::min(__runs.size(), __i + __fan_in);
+            if (__end - __i == 1) {
+                __merged.push_back(std::move(__runs[__i]));
+            } else {
+                __merged.push_back(__merge_runs<_Value>(
+                    std::vector<__spill_run>(std::make_move_iterator(__runs.begin() + __i),
+                                             std::make_move_iterator(__runs.begin() + __end)),
+                    __memory_budget, __tmpdir));
+            }
+        }
+        __runs = std::move(__merged);
+    }
+
+    const std::size_t __buffer_bytes = __memory_budget / __runs.size();
+    std::vector<std::generator<_Value>> __readers;
+    for (__spill_run& __r : __runs) {
+        __readers.push_back(__read_run<_Value>(std::move(__r), __buffer_bytes));
+    }
+    __runs.clear();
+    auto __merged = std::experimental::merge(std::move(__readers));
+    for (auto __it = __merged.begin(); __it != __merged.end(); ++__it) {
+        co_yield __it.take();
+    }
+}
+
+// Yields the values of __gen in ascending order, using about
+// __memory_budget bytes of memory and spilling to files in __tmpdir. Runs
+// are sorted on __pool.
+template <typename _Ref, typename _Value, typename _Alloc>
+    requires __spillable<_Value>
+std::generator<_Value> external_sort(std::generator<_Ref, _Value, _Alloc> __gen,
+                                     std::size_t __memory_budget,
+                                     std::filesystem::path __tmpdir,
+                                     thread_pool& __pool) {
+    return std::experimental::__external_sort(
+        std::move(__gen), __memory_budget, std::move(__tmpdir), std::addressof(__pool));
+}
+
+// As above, with runs sorted on a thread_pool created for the purpose once
+// the first run fills up.
+template <typename _Ref, typename _Value, typename _Alloc>
+    requires __spillable<_Value>
+std::generator<_Value> external_sort(std::generator<_Ref, _Value, _Alloc> __gen,
+                                     std::size_t __memory_budget,
+                                     std::filesystem::path __tmpdir =
+                                         std::filesystem::temp_directory_path()) {
+    return std::experimental::__external_sort(
+        std::move(__gen), __memory_budget, std::move(__tmpdir), nullptr);
+}
+
+} // namespace std::experimental
+
+#endif // __STD_EXTERNAL_SORT_INCLUDED
@@ -0,0 +1,209 @@
+#ifndef __STD_FLAT_GENERATOR_INCLUDED
+#define __STD_FLAT_GENERATOR_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// flat_generator<Ref, Value, Alloc>: a generator that cannot nest other
+// generators and must not throw.
+//
+// std::generator keeps a root pointer, a parent-or-leaf handle and storage
+// for a nested exception in every frame, and yields through the root
+// pointer, so that any generator can be nested with elements_of. A leaf
+// generator that does neither pays for these anyway. flat_generator's
+// promise only holds the current value: co_yield stores it directly, and
+// the consumer resumes the coroutine's own handle.
+//
+// co_yield std::ranges::elements_of(...) is not supported, and an
+// exception escaping the coroutine body calls std::terminate(). A
+// flat_generator can itself be yielded via elements_of from a
+// std::generator like any other range.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace std::experimental {
+
+template <typename _Ref, typename _Value = std::remove_cvref_t<_Ref>,
+          typename _Alloc = std::allocator<std::byte>>
+class flat_generator;
+
+template <typename _Ref, typename _Value, typename _Alloc>
+struct __flat_generator_promise final
+    : public __promise_base_alloc<__byte_allocator_t<_Alloc>> {
+    __manual_lifetime<_Ref> __value_;
+
+    __flat_generator_promise() noexcept {
+        __generator_frames::__discard_allocation();
+    }
+
+    flat_generator<_Ref, _Value, _Alloc> get_return_object() noexcept {
+        return flat_generator<_Ref, _Value, _Alloc>{
+            std::coroutine_handle<__flat_generator_promise>::from_promise(*this)
+        };
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    std::suspend_always final_suspend() noexcept {
+        return {};
+    }
+
+    void return_void() noexcept {}
+
+    [[noreturn]] void unhandled_exception() noexcept {
+        std::terminate();
+    }
+
+    std::suspend_always yield_value(_Ref&& __x)
+            noexcept(std::is_nothrow_move_constructible_v<_Ref>) {
+        __value_.construct((_Ref&&)__x);
+        return {};
+    }
+
+    template <typename _T>
+    requires
+        (!std::is_reference_v<_Ref>) &&
+        std::is_convertible_v<_T, _Ref>
+    std::suspend_always yield_value(_T&& __x)
+            noexcept(std::is_nothrow_constructible_v<_Ref, _T>) {
+        __value_.construct((_T&&)__x);
+        return {};
+    }
+
+    // Disable use of co_await within this coroutine.
+    void await_transform() = delete;
+};
+
+template <typename _Ref, typename _Value, typename _Alloc>
+class flat_generator {
+public:
+    using promise_type = __flat_generator_promise<_Ref, _Value, _Alloc>;
+    friend promise_type;
+private:
+    using __coroutine_handle = std::coroutine_handle<promise_type>;
+public:
+
+    flat_generator() noexcept = default;
+
+    flat_generator(flat_generator&& __other) noexcept
+        : __coro_(std::exchange(__other.__coro_, {}))
+        , __started_(std::exchange(__other.__started_, false)) {
+    }
+
+    ~flat_generator() noexcept {
+        if (__coro_) {
+            if (__started_ && !__coro_.done()) {
+                __coro_.promise().__value_.destruct();
+            }
+            __coro_.destroy();
+        }
+    }
+
+    flat_generator& operator=(flat_generator&& __g) noexcept {
+        swap(__g);
+        return *this;
+    }
+
+    void swap(flat_generator& __other) noexcept {
+        std::swap(__coro_, __other.__coro_);
+        std::swap(__started_, __other.__started_);
+    }
+
+    struct sentinel {};
+
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = _Value;
+        using reference = _Ref;
+        using pointer = std::add_pointer_t<_Ref>;
+
+        iterator() noexcept = default;
+        iterator(const iterator &) = delete;
+
+        iterator(iterator&& __other) noexcept
+        : __coro_(std::exchange(__other.__coro_, {})) {
+        }
+
+        iterator& operator=(iterator&& __other) {
+            std::swap(__coro_, __other.__coro_);
+            return *this;
+        }
+
+        friend bool operator==(const iterator &it, sentinel) noexcept {
+            return it.__coro_.done();
+        }
+
+        iterator &operator++() {
+            __coro_.promise().__value_.destruct();
+            typename promise_type::__resume_guard __guard{__coro_.promise()};
+            __coro_.resume();
+            return *this;
+        }
+
+        void operator++(int) {
+            (void)operator++();
+        }
+
+        reference operator*() const noexcept {
+            return static_cast<reference>(__coro_.promise().__value_.get());
+        }
+
+      private:
+        friend flat_generator;
+
+        explicit iterator(__coroutine_handle __coro) noexcept
+        : __coro_(__coro) {}
+
+        __coroutine_handle __coro_;
+    };
+
+    iterator begin() {
+        assert(__coro_);
+        assert(!__started_);
+        __started_ = true;
+        typename promise_type::__resume_guard __guard{__coro_.promise()};
+        __coro_.resume();
+        return iterator{__coro_};
+    }
+
+    sentinel end() noexcept {
+        return {};
+    }
+
+private:
+    explicit flat_generator(__coroutine_handle __coro) noexcept
+        : __coro_(__coro) {
+    }
+
+    __coroutine_handle __coro_;
+    bool __started_ = false;
+};
+
+} // namespace std::experimental
+
+#if __has_include(<ranges>)
+namespace std::ranges {
+
+template <typename _Ref, typename _Value, typename _Alloc>
+constexpr inline bool enable_view<experimental::flat_generator<_Ref, _Value, _Alloc>> = true;
+
+} // namespace std::ranges
+#endif
+
+#endif // __STD_FLAT_GENERATOR_INCLUDED
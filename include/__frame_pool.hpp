@@ -0,0 +1,284 @@
+#ifndef __STD_FRAME_POOL_INCLUDED
+#define __STD_FRAME_POOL_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// Thread-local size-class pool allocator for generator coroutine frames.
+//
+// Generator frames are allocated and freed at a high rate and have a small
+// number of distinct sizes (one per coroutine function). frame_pool_allocator
+// keeps per-thread free lists bucketed by the size the compiler passes to the
+// promise's operator new, so that steady-state creation and destruction of
+// generators does not touch the global heap.
+//
+// Frames may be destroyed on a different thread from the one that allocated
+// them. Such frees are pushed onto a lock-free list owned by the allocating
+// thread's pool, which reclaims them the next time a free list runs dry.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace std::experimental {
+
+class __frame_pool {
+public:
+    // Block sizes are rounded up to a multiple of the granularity. Requests
+    // larger than __max_pooled_size bypass the pool.
+    static constexpr std::size_t __granularity = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static constexpr std::size_t __max_pooled_size = 1024;
+    static constexpr std::size_t __class_count = __max_pooled_size / __granularity;
+
+    // Upper bound on the number of free blocks cached per size class.
+    static constexpr std::size_t __max_cached_per_class = 128;
+
+    static void* allocate(std::size_t __size) {
+        if (__size > __max_pooled_size) {
+            return ::operator new(__size);
+        }
+
+        const std::size_t __cls = __size_class(__size);
+        __frame_pool* __pool = __this_thread();
+        if (__pool == nullptr) {
+            // Thread is shutting down and has already released its pool.
+            __header* __h = static_cast<__header*>(::operator new(__block_size(__cls)));
+            __h->__owner_ = nullptr;
+            __h->__class_ = __cls;
+            return __h + 1;
+        }
+        return __pool->__allocate(__cls);
+    }
+
+    static void deallocate(void* __ptr, std::size_t __size) noexcept {
+        if (__size > __max_pooled_size) {
+            ::operator delete(__ptr, __size);
+            return;
+        }
+
+        __header* __h = static_cast<__header*>(__ptr) - 1;
+        __frame_pool* __owner = __h->__owner_;
+        if (__owner == nullptr) {
+            ::operator delete(__h, __block_size(__h->__class_));
+        } else if (__owner == __current_) {
+            __owner->__release_local(__h);
+        } else {
+            __owner->__release_remote(__h);
+        }
+    }
+
+private:
+    // Every pooled block is prefixed with a header that records the pool
+    // that allocated it. The header keeps the payload suitably aligned.
+    struct alignas(__granularity) __header {
+        __frame_pool* __owner_;
+        std::size_t __class_;
+    };
+
+    // Free blocks reuse the first word of their payload as the list link.
+    struct __free_block {
+        __free_block* __next_;
+    };
+
+    static constexpr std::size_t __size_class(std::size_t __size) noexcept {
+        return __size == 0 ? 0 : (__size - 1) / __granularity;
+    }
+
+    static constexpr std::size_t __block_size(std::size_t __cls) noexcept {
+        return sizeof(__header) + (__cls + 1) * __granularity;
+    }
+
+    static __free_block* __link(__header* __h) noexcept {
+        return reinterpret_cast<__free_block*>(__h + 1);
+    }
+
+    static __header* __unlink(__free_block* __b) noexcept {
+        return reinterpret_cast<__header*>(__b) - 1;
+    }
+
+    // Sentinel stored in __remote_ once the owning thread has exited.
+    static __free_block* __closed() noexcept {
+        return reinterpret_cast<__free_block*>(std::uintptr_t(1));
+    }
+
+    struct __thread_handle {
+        __thread_handle() {
+            __current_ = new __frame_pool;
+        }
+
+        ~__thread_handle() {
+            __frame_pool* __pool = __current_;
+            __current_ = nullptr;
+            __torn_down_ = true;
+            __pool->__abandon();
+        }
+    };
+
+    static __frame_pool* __this_thread() {
+        __frame_pool* __pool = __current_;
+        if (__pool != nullptr) [[likely]] {
+            return __pool;
+        }
+        if (__torn_down_) {
+            return nullptr;
+        }
+        thread_local __thread_handle __handle;
+        return __current_;
+    }
+
+    void* __allocate(std::size_t __cls) {
+        if (__free_[__cls] == nullptr && __remote_.load(std::memory_order_relaxed) != nullptr) {
+            __reclaim_remote();
+        }
+
+        ++__outstanding_;
+        if (__free_block* __b = __free_[__cls]) {
+            __free_[__cls] = __b->__next_;
+            --__cached_[__cls];
+            return __b;
+        }
+
+        __header* __h;
+        try {
+            __h = static_cast<__header*>(::operator new(__block_size(__cls)));
+        } catch (...) {
+            --__outstanding_;
+            throw;
+        }
+        __h->__owner_ = this;
+        __h->__class_ = __cls;
+        return __h + 1;
+    }
+
+    // Return a block to its size class, or to the global heap if the class
+    // already holds enough cached blocks.
+    void __cache(__header* __h) noexcept {
+        const std::size_t __cls = __h->__class_;
+        if (__cached_[__cls] < __max_cached_per_class) {
+            __free_block* __b = __link(__h);
+            __b->__next_ = __free_[__cls];
+            __free_[__cls] = __b;
+            ++__cached_[__cls];
+        } else {
+            ::operator delete(__h, __block_size(__cls));
+        }
+    }
+
+    void __release_local(__header* __h) noexcept {
+        --__outstanding_;
+        __cache(__h);
+    }
+
+    void __release_remote(__header* __h) noexcept {
+        __free_block* __b = __link(__h);
+        __free_block* __head = __remote_.load(std::memory_order_relaxed);
+        do {
+            if (__head == __closed()) {
+                // The owning thread has exited. Free the block directly and
+                // destroy the pool once its last outstanding block is gone.
+                ::operator delete(__h, __block_size(__h->__class_));
+                if (__orphans_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete this;
+                }
+                return;
+            }
+            __b->__next_ = __head;
+        } while (!__remote_.compare_exchange_weak(
+            __head, __b, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void __reclaim_remote() noexcept {
+        __free_block* __b = __remote_.exchange(nullptr, std::memory_order_acquire);
+        while (__b != nullptr) {
+            __free_block* __next = __b->__next_;
+            --__outstanding_;
+            __cache(__unlink(__b));
+            __b = __next;
+        }
+    }
+
+    // Called on thread exit. Frees everything this pool caches and hands
+    // ownership of the pool to whichever thread frees its last block.
+    void __abandon() noexcept {
+        __free_block* __b = __remote_.exchange(__closed(), std::memory_order_acq_rel);
+        while (__b != nullptr) {
+            __free_block* __next = __b->__next_;
+            --__outstanding_;
+            __header* __h = __unlink(__b);
+            ::operator delete(__h, __block_size(__h->__class_));
+            __b = __next;
+        }
+
+        for (std::size_t __cls = 0; __cls < __class_count; ++__cls) {
+            __b = __free_[__cls];
+            while (__b != nullptr) {
+                __free_block* __next = __b->__next_;
+                ::operator delete(__unlink(__b), __block_size(__cls));
+                __b = __next;
+            }
+        }
+
+        const std::ptrdiff_t __remaining = static_cast<std::ptrdiff_t>(__outstanding_);
+        if (__orphans_.fetch_add(__remaining, std::memory_order_acq_rel) + __remaining == 0) {
+            delete this;
+        }
+    }
+
+    static inline thread_local __frame_pool* __current_ = nullptr;
+    static inline thread_local bool __torn_down_ = false;
+
+    // Owner-thread state.
+    __free_block* __free_[__class_count] = {};
+    std::size_t __cached_[__class_count] = {};
+    std::size_t __outstanding_ = 0;
+
+    // Blocks freed by other threads (multi-producer, single-consumer).
+    std::atomic<__free_block*> __remote_{nullptr};
+
+    // Outstanding blocks still to be freed after the owner thread exits.
+    std::atomic<std::ptrdiff_t> __orphans_{0};
+};
+
+// Stateless allocator that draws from the calling thread's frame pool.
+//
+// Usable both as the allocator parameter of std::generator and as the
+// allocator passed after std::allocator_arg to a generator coroutine.
+template <typename _T>
+class frame_pool_allocator {
+    static_assert(alignof(_T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "frame_pool_allocator does not support over-aligned types");
+
+public:
+    using value_type = _T;
+    using is_always_equal = std::true_type;
+
+    frame_pool_allocator() noexcept = default;
+
+    template <typename _U>
+    frame_pool_allocator(const frame_pool_allocator<_U>&) noexcept {}
+
+    _T* allocate(std::size_t __n) {
+        return static_cast<_T*>(__frame_pool::allocate(__n * sizeof(_T)));
+    }
+
+    void deallocate(_T* __p, std::size_t __n) noexcept {
+        __frame_pool::deallocate(__p, __n * sizeof(_T));
+    }
+
+    template <typename _U>
+    friend bool operator==(const frame_pool_allocator&, const frame_pool_allocator<_U>&) noexcept {
+        return true;
+    }
+};
+
+} // namespace std::experimental
+
+#endif // __STD_FRAME_POOL_INCLUDED
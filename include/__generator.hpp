@@ -29,6 +29,7 @@ using std::experimental::suspend_never;
 } // namespace std
 #endif
 
+#include <algorithm>
 #include <exception>
 #include <iterator>
 #include <new>
@@ -37,6 +38,21 @@ using std::experimental::suspend_never;
 #include <concepts>
 #include <cassert>
 
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#include <__generator_frames.hpp>
+#include <__generator_stats.hpp>
+#include <__generator_trace.hpp>
+
+// Marks the declarations exported by the stdgenerator module. The module
+// interface unit (modules/stdgenerator.cppm) defines it as 'export' before
+// including this header; everywhere else it expands to nothing.
+#ifndef __STDGENERATOR_EXPORT
+#define __STDGENERATOR_EXPORT
+#endif
+
 #if __has_include(<ranges>)
 #  include <ranges>
 #else
@@ -217,11 +233,76 @@ class __manual_lifetime<_T&&> {
     _T* __value_;
 };
 
-struct use_allocator_arg {};
+// Current value of a generator, set by the producer and read by the
+// consumer while the producer is suspended.
+//
+// __set(__x) refers to __x when it is an lvalue of type _T, and otherwise
+// constructs a _T from it. The producer keeps such an lvalue alive until it
+// is resumed, so it need not be copied. Consumers only move from the value
+// if it was constructed here (__movable()).
+//
+// For reference types this is __manual_lifetime, which always refers.
+template <typename _T>
+class __yielded_value : public __manual_lifetime<_T> {
+  public:
+    template <typename _U>
+    void __set(_U&& __x) noexcept {
+        this->construct((_U&&)__x);
+    }
+
+    bool __movable() const noexcept {
+        return true;
+    }
+};
+
+template <typename _T>
+    requires (!std::is_reference_v<_T>)
+class __yielded_value<_T> {
+    using __object_t = std::remove_const_t<_T>;
+
+  public:
+    __yielded_value() noexcept {}
+
+    template <typename _U>
+    static constexpr bool __refers_to = std::is_lvalue_reference_v<_U> &&
+                                        std::is_same_v<std::remove_cvref_t<_U>, __object_t>;
+
+    template <typename _U>
+    void __set(_U&& __x) noexcept(__refers_to<_U> || std::is_nothrow_constructible_v<_T, _U>) {
+        if constexpr (__refers_to<_U>) {
+            __ptr_ = const_cast<__object_t*>(std::addressof(__x));
+            __movable_ = false;
+        } else {
+            __ptr_ = const_cast<__object_t*>(std::addressof(__storage_.construct((_U&&)__x)));
+            __movable_ = true;
+        }
+    }
+
+    void destruct() noexcept(std::is_nothrow_destructible_v<_T>) {
+        if (__ptr_ == std::addressof(__storage_.get())) {
+            __storage_.destruct();
+        }
+    }
+
+    _T& get() const noexcept {
+        return *__ptr_;
+    }
+
+    bool __movable() const noexcept {
+        return __movable_;
+    }
+
+  private:
+    __object_t* __ptr_ = nullptr;
+    bool __movable_ = false;
+    __manual_lifetime<_T> __storage_;
+};
+
+__STDGENERATOR_EXPORT struct use_allocator_arg {};
 
 namespace ranges {
 
-template <typename _Rng, typename _Allocator = use_allocator_arg>
+__STDGENERATOR_EXPORT template <typename _Rng, typename _Allocator = use_allocator_arg>
 struct elements_of {
     explicit constexpr elements_of(_Rng&& __rng) noexcept
     requires std::is_default_constructible_v<_Allocator>
@@ -256,10 +337,84 @@ elements_of(_Rng &&) -> elements_of<_Rng>;
 template <typename _Rng, typename Allocator>
 elements_of(_Rng &&, Allocator&&) -> elements_of<_Rng, Allocator>;
 
+// Yielded by a generator to tell bulk consumers such as drain_into() how
+// many more values to expect. Does not suspend the generator.
+__STDGENERATOR_EXPORT struct size_hint {
+    explicit constexpr size_hint(size_t __count) noexcept
+    : __count(__count) {}
+
+    constexpr size_t count() const noexcept {
+        return __count;
+    }
+
+private:
+    size_t __count; // \expos
+};
+
+// Yielded by a generator over a sorted sequence to let the consumer skip
+// ahead with iterator::skip_to(). co_yield seekable(x) yields x and
+// evaluates to a pointer to the key the consumer wants to skip to, or to
+// nullptr if the consumer simply incremented the iterator.
+__STDGENERATOR_EXPORT template <typename _T>
+struct seekable {
+    explicit constexpr seekable(_T&& __value) noexcept
+    : __value(std::forward<_T>(__value)) {}
+
+    constexpr _T&& get() const noexcept {
+        return std::forward<_T>(__value);
+    }
+
+private:
+    _T&& __value; // \expos
+};
+
+template <typename _T>
+seekable(_T&&) -> seekable<_T>;
+
 } // namespace ranges
 
+// Whether a _From converts to _Ref without binding _Ref to a temporary.
+// A value set on the root from such a temporary would refer to an object
+// destroyed before the consumer reads it.
+template <typename _Ref, typename _From>
+concept __converts_without_temporary =
+    !std::is_reference_v<_Ref> ||
+    (std::is_reference_v<_From> &&
+     std::is_convertible_v<std::remove_reference_t<_From>*, std::remove_reference_t<_Ref>*>);
+
+// Ranges whose elements can be handed to the consumer of a generator
+// directly by iterating the range, rather than by wrapping the range in a
+// nested generator. Iteration and conversion to the reference type must not
+// throw, as they are performed by the consumer rather than the producer.
+#if __has_include(<ranges>)
+template <typename _Rng, typename _Ref>
+concept __delegatable_range =
+    std::ranges::forward_range<_Rng> &&
+    std::is_nothrow_convertible_v<std::ranges::range_reference_t<_Rng>, _Ref> &&
+    __converts_without_temporary<_Ref, std::ranges::range_reference_t<_Rng>> &&
+    requires(std::ranges::iterator_t<_Rng>& __it, const std::ranges::sentinel_t<_Rng>& __end) {
+        { *__it } noexcept;
+        { ++__it } noexcept;
+        { __it == __end } noexcept;
+    };
+
+// Delegatable ranges whose elements can be walked with an _Element pointer.
+template <typename _Rng, typename _Element>
+concept __contiguous_range_of =
+    std::ranges::contiguous_range<_Rng> &&
+    std::ranges::sized_range<_Rng> &&
+    std::is_convertible_v<
+        std::remove_reference_t<std::ranges::range_reference_t<_Rng>>(*)[], _Element(*)[]>;
+#else
+template <typename _Rng, typename _Ref>
+concept __delegatable_range = std::ranges::range<_Rng> && false;
+
+template <typename _Rng, typename _Element>
+concept __contiguous_range_of = false;
+#endif
+
 template <typename _Alloc>
-static constexpr bool __allocator_needs_to_be_stored =
+inline constexpr bool __allocator_needs_to_be_stored =
     !std::allocator_traits<_Alloc>::is_always_equal::value ||
     !std::is_default_constructible_v<_Alloc>;
 
@@ -269,11 +424,23 @@ constexpr size_t __aligned_allocation_size(size_t s, size_t a) {
 }
 
 
-template <typename _Ref,
+__STDGENERATOR_EXPORT template <typename _Ref,
           typename _Value = std::remove_cvref_t<_Ref>,
           typename _Allocator = use_allocator_arg>
 class generator;
 
+// Generators whose reference type is not _Ref but converts to it. These are
+// nested by the promise without wrapping them in another generator. Their
+// values are read in place, as glvalues of the nested value, so a reference
+// _Ref must bind to that value rather than to a temporary converted from it.
+template <typename _Rng, typename _Ref>
+inline constexpr bool __convertible_generator = false;
+
+template <typename _ORef, typename _OValue, typename _OAlloc, typename _Ref>
+inline constexpr bool __convertible_generator<generator<_ORef, _OValue, _OAlloc>, _Ref> =
+    !std::is_same_v<_ORef, _Ref> && std::is_convertible_v<_ORef, _Ref> &&
+    __converts_without_temporary<_Ref, std::add_lvalue_reference_t<_ORef>>;
+
 template<typename _Alloc>
 class __promise_base_alloc {
     static constexpr std::size_t __offset_of_allocator(std::size_t __frameSize) noexcept {
@@ -289,10 +456,10 @@ class __promise_base_alloc {
             static_cast<char*>(__frame) + __offset_of_allocator(__frameSize));
     }
 
-public:
-    template<typename... _Args>
-    static void* operator new(std::size_t __frameSize, std::allocator_arg_t, _Alloc __alloc, _Args&...) {
+    static void* __allocate(std::size_t __frameSize, _Alloc __alloc) {
         void* __frame = __alloc.allocate(__padded_frame_size(__frameSize));
+        __generator_instrumentation::__on_allocate(__padded_frame_size(__frameSize));
+        __generator_frames::__on_allocate(__padded_frame_size(__frameSize));
 
         // Store allocator at end of the coroutine frame.
         // Assuming the allocator's move constructor is non-throwing (a requirement for allocators)
@@ -301,17 +468,42 @@ public:
         return __frame;
     }
 
+public:
+    // A template, so that it accepts any coroutine parameters. GCC at -O0
+    // therefore reports it as mismatched with operator delete; see
+    // std::pmr::generator.
+    template<typename... _Args>
+    static void* operator new(std::size_t __frameSize, std::allocator_arg_t, _Alloc __alloc, _Args&...) {
+        return __promise_base_alloc::__allocate(__frameSize, std::move(__alloc));
+    }
+
     template<typename _This, typename... _Args>
     static void* operator new(std::size_t __frameSize, _This&, std::allocator_arg_t, _Alloc __alloc, _Args&...) {
-        return __promise_base_alloc::operator new(__frameSize, std::allocator_arg, std::move(__alloc));
+        return __promise_base_alloc::__allocate(__frameSize, std::move(__alloc));
+    }
+
+    // Without std::allocator_arg, a default-constructed allocator is used,
+    // e.g. a polymorphic_allocator of the default memory resource.
+    static void* operator new(std::size_t __frameSize)
+        requires std::default_initializable<_Alloc>
+    {
+        return __promise_base_alloc::__allocate(__frameSize, _Alloc());
     }
 
     static void operator delete(void* __ptr, std::size_t __frameSize) noexcept {
         _Alloc& __alloc = __get_allocator(__ptr, __frameSize);
         _Alloc __localAlloc(std::move(__alloc));
-        __alloc.~Alloc();
+        __alloc.~_Alloc();
         __localAlloc.deallocate(static_cast<std::byte*>(__ptr), __padded_frame_size(__frameSize));
+        __generator_instrumentation::__on_deallocate();
     }
+
+    // Constructed around every resumption of the coroutine tree performed
+    // by a generator whose allocator type is known statically. Allocators
+    // that need to observe resumption specialise __promise_base_alloc.
+    struct __resume_guard {
+        explicit __resume_guard(__promise_base_alloc&) noexcept {}
+    };
 };
 
 template<typename _Alloc>
@@ -320,34 +512,170 @@ class __promise_base_alloc<_Alloc> {
 public:
     static void* operator new(std::size_t __size) {
         _Alloc __alloc;
-        return __alloc.allocate(__size);
+        void* __frame = __alloc.allocate(__size);
+        __generator_instrumentation::__on_allocate(__size);
+        __generator_frames::__on_allocate(__size);
+        return __frame;
     }
 
     static void operator delete(void* __ptr, std::size_t __size) noexcept {
         _Alloc __alloc;
         __alloc.deallocate(static_cast<std::byte*>(__ptr), __size);
+        __generator_instrumentation::__on_deallocate();
     }
+
+    struct __resume_guard {
+        explicit __resume_guard(__promise_base_alloc&) noexcept {}
+    };
+};
+
+// Links of a tree of generator coroutines nested with elements_of(),
+// shared by the promise bases of std::generator and of the experimental
+// generators built on it.
+//
+// Every coroutine in the tree points at the root. The root's
+// __parentOrLeaf_ is the innermost coroutine, which the consumer resumes
+// directly; every other coroutine's is its parent. When a nested coroutine
+// completes, control transfers straight to its parent.
+//
+// _Promise derives from this class. It decides how a value is handed to the
+// consumer, and provides:
+//   __on_nest(__nested, __coro): called on the parent once the promise
+//       __nested of coroutine __coro has been linked below it;
+//   __on_unnest(__coro): called when the nested coroutine __coro completes;
+//   __rethrow_if_failed(): rethrows the exception that escaped a completed
+//       nested coroutine, if any;
+//   __root_continuation(): the coroutine to transfer to once the root
+//       completes.
+template <typename _Promise>
+struct __generator_nesting {
+    _Promise* __root_;
+    std::coroutine_handle<> __parentOrLeaf_;
+
+    __generator_nesting(_Promise* __self, std::coroutine_handle<> __thisCoro) noexcept
+        : __root_(__self)
+        , __parentOrLeaf_(__thisCoro)
+    {}
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    // Transfers control back to the parent of a nested coroutine
+    struct __final_awaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        template <typename _P>
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<_P> __h) noexcept {
+            _Promise& __promise = __h.promise();
+            _Promise& __root = *__promise.__root_;
+            if (&__root != &__promise) {
+                __promise.__on_unnest(__h);
+                auto __parent = __promise.__parentOrLeaf_;
+                __root.__parentOrLeaf_ = __parent;
+                return __parent;
+            }
+            return __root.__root_continuation();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    __final_awaiter final_suspend() noexcept {
+        return {};
+    }
+
+    template <typename _Gen>
+    struct __yield_sequence_awaiter {
+        _Gen __gen_;
+
+        __yield_sequence_awaiter(_Gen&& __g) noexcept
+            // Taking ownership of the generator ensures frame are destroyed
+            // in the reverse order of their execution.
+            : __gen_((_Gen&&)__g) {
+        }
+
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        // set the parent, root and exceptions pointer and
+        // resume the nested
+        template <typename _P>
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<_P> __h) noexcept {
+            _Promise& __current = __h.promise();
+            _Promise& __nested = *__gen_.__get_promise();
+
+            __nested.__root_ = __current.__root_;
+            __nested.__parentOrLeaf_ = __h;
+            __current.__root_->__parentOrLeaf_ = __gen_.__get_coro();
+            __current.__on_nest(__nested, __gen_.__get_coro());
+
+            // Immediately resume the nested coroutine (nested generator)
+            return __gen_.__get_coro();
+        }
+
+        void await_resume() {
+            __gen_.__get_promise()->__rethrow_if_failed();
+        }
+    };
 };
 
 template<typename _Ref>
 struct __generator_promise_base
+    : __generator_depth
+    , __generator_nesting<__generator_promise_base<_Ref>>
 {
     template <typename _Ref2, typename _Value, typename _Alloc>
     friend class generator;
 
-    __generator_promise_base* __root_;
-    std::coroutine_handle<> __parentOrLeaf_;
+    // Registers the frame with the frame registry, if enabled.
+    [[no_unique_address]] __generator_frame_handle __frame_;
+
+    // Element type of contiguous ranges that the consumer walks by pointer.
+    using __element_t = std::conditional_t<
+        std::is_reference_v<_Ref>, std::remove_reference_t<_Ref>, const _Ref>;
+
+    // Source of values that the consumer pulls directly, without resuming
+    // the producer, until it is exhausted. Only used on the root.
+    // Contiguous ranges are walked inline through [__cur_, __end_); other
+    // ranges provide __next_ to produce the next value.
+    struct __delegate {
+        __element_t* __cur_;
+        __element_t* __end_;
+        bool (*__next_)(__delegate*, __generator_promise_base&) noexcept;
+    };
+
+    using __nesting = __generator_nesting<__generator_promise_base>;
+    using __nesting::__root_;
+    using __nesting::__parentOrLeaf_;
+
+    template <typename _Gen>
+    using __yield_sequence_awaiter = typename __nesting::template __yield_sequence_awaiter<_Gen>;
+
+    __delegate* __delegate_ = nullptr;
+    // Most recent size hint yielded to this root; cleared once applied.
+    size_t __size_hint_ = 0;
+    // Set on the root while the leaf is suspended at a co_yield seekable(),
+    // which receives the consumer's skip_to() key through it.
+    struct __seek_point {
+        const std::remove_cvref_t<_Ref>* __key_ = nullptr;
+    };
+    __seek_point* __seek_ = nullptr;
     // Note: Using manual_lifetime here to avoid extra calls to exception_ptr
     // constructor/destructor in cases where it is not needed (i.e. where this
     // generator coroutine is not used as a nested coroutine).
-    // This member is lazily constructed by the __yield_sequence_awaiter::await_suspend()
-    // method if this generator is used as a nested generator.
+    // This member is lazily constructed by __on_nest() if this generator is
+    // used as a nested generator.
     __manual_lifetime<std::exception_ptr> __exception_;
-    __manual_lifetime<_Ref> __value_;
+    __yielded_value<_Ref> __value_;
 
     explicit __generator_promise_base(std::coroutine_handle<> thisCoro) noexcept
-        : __root_(this)
-        , __parentOrLeaf_(thisCoro)
+        : __nesting(this, thisCoro)
     {}
 
     ~__generator_promise_base() {
@@ -359,10 +687,6 @@ struct __generator_promise_base
         }
     }
 
-    std::suspend_always initial_suspend() noexcept {
-        return {};
-    }
-
     void return_void() noexcept {}
 
     void unhandled_exception() {
@@ -373,96 +697,259 @@ struct __generator_promise_base
         }
     }
 
-    // Transfers control back to the parent of a nested coroutine
-    struct __final_awaiter {
-        bool await_ready() noexcept {
-            return false;
-        }
+    // Called on the parent once __nested has been linked below it.
+    void __on_nest(__generator_promise_base& __nested, std::coroutine_handle<> __coro) noexcept {
+        // Lazily construct the __exception_ member here now that we
+        // know it will be used as a nested generator. This will be
+        // destroyed by the promise destructor.
+        __nested.__exception_.construct();
+        this->__enter(__nested, *__root_);
+        __generator_instrumentation::__on_nested_entry(__nested);
+        __generator_trace::__on_nested_entry(__coro.address(), __nested);
+    }
 
-        template <typename _Promise>
-        std::coroutine_handle<>
-        await_suspend(std::coroutine_handle<_Promise> __h) noexcept {
-            _Promise& __promise = __h.promise();
-            __generator_promise_base& __root = *__promise.__root_;
-            if (&__root != &__promise) {
-                auto __parent = __promise.__parentOrLeaf_;
-                __root.__parentOrLeaf_ = __parent;
-                return __parent;
-            }
-            return std::noop_coroutine();
-        }
+    void __on_unnest(std::coroutine_handle<> __coro) noexcept {
+        __generator_instrumentation::__on_nested_exit(static_cast<bool>(__exception_.get()));
+        __generator_trace::__on_nested_exit(__coro.address(), *this);
+        this->__exit(*__root_);
+    }
 
-        void await_resume() noexcept {}
-    };
+    void __rethrow_if_failed() {
+        if (__exception_.get()) {
+            std::rethrow_exception(std::move(__exception_.get()));
+        }
+    }
 
-    __final_awaiter final_suspend() noexcept {
-        return {};
+    std::coroutine_handle<> __root_continuation() noexcept {
+        return std::noop_coroutine();
     }
 
     std::suspend_always yield_value(_Ref&& __x)
             noexcept(std::is_nothrow_move_constructible_v<_Ref>) {
-        __root_->__value_.construct((_Ref&&)__x);
+        __root_->__value_.__set((_Ref&&)__x);
+        return {};
+    }
+
+    // An lvalue of the value type lives until the producer is resumed, so
+    // the consumer reads it in place instead of a copy.
+    std::suspend_always yield_value(const _Ref& __x) noexcept
+    requires (!std::is_reference_v<_Ref>) && std::is_copy_constructible_v<_Ref> {
+        __root_->__value_.__set(__x);
         return {};
     }
 
     template <typename _T>
     requires
         (!std::is_reference_v<_Ref>) &&
+        (!std::is_same_v<std::remove_cvref_t<_T>, std::remove_cv_t<_Ref>>) &&
         std::is_convertible_v<_T, _Ref>
     std::suspend_always yield_value(_T&& __x)
             noexcept(std::is_nothrow_constructible_v<_Ref, _T>) {
-        __root_->__value_.construct((_T&&)__x);
+        __root_->__value_.__set((_T&&)__x);
+        return {};
+    }
+
+    std::suspend_never yield_value(std::ranges::size_hint __hint) noexcept {
+        __root_->__size_hint_ = __hint.count();
         return {};
     }
 
+    struct __seekable_awaiter : __seek_point {
+        __generator_promise_base* __root_;
+
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<>) noexcept {
+            __root_->__seek_ = this;
+        }
+
+        const std::remove_cvref_t<_Ref>* await_resume() noexcept {
+            __root_->__seek_ = nullptr;
+            return this->__key_;
+        }
+    };
+
+    template <typename _T>
+    __seekable_awaiter yield_value(std::ranges::seekable<_T> __x)
+            noexcept(noexcept(std::declval<__generator_promise_base&>().yield_value(__x.get()))) {
+        (void)yield_value(__x.get());
+        return __seekable_awaiter{{}, __root_};
+    }
+
+    // Advances past values less than __key. A producer suspended at a
+    // co_yield seekable() is handed __key and can jump ahead itself;
+    // otherwise values are skipped one at a time.
+    void __skip_to(std::coroutine_handle<> __coro, const std::remove_cvref_t<_Ref>& __key) {
+        while (!__coro.done() && __value_.get() < __key) {
+            if (__seek_ != nullptr) {
+                __seek_->__key_ = std::addressof(__key);
+            }
+            __value_.destruct();
+            resume();
+        }
+    }
+
+    template <typename _OValue, typename _OAlloc>
+    __yield_sequence_awaiter<generator<_Ref, _OValue, _OAlloc>>
+    yield_value(std::ranges::elements_of<generator<_Ref, _OValue, _OAlloc>> __g) noexcept {
+        return std::move(__g).get();
+    }
+
+    // Nests a generator whose reference type differs from _Ref but converts
+    // to it. Its promise cannot join this chain, as its values are not
+    // _Refs, so the awaiter drives it as a root of its own and registers
+    // itself as our root's delegate: the consumer advances the nested
+    // generator and converts each value as it is set on our root, without
+    // resuming the producer in between. An exception thrown by the nested
+    // generator is rethrown from the producer's co_yield.
     template <typename _Gen>
-    struct __yield_sequence_awaiter {
+    struct __yield_generator_awaiter : __delegate {
         _Gen __gen_;
+        typename _Gen::iterator __it_;
+        std::exception_ptr __exception_;
 
-        __yield_sequence_awaiter(_Gen&& __g) noexcept
-            // Taking ownership of the generator ensures frame are destroyed
-            // in the reverse order of their execution.
-            : __gen_((_Gen&&)__g) {
+        explicit __yield_generator_awaiter(_Gen&& __g) noexcept
+            : __delegate{nullptr, nullptr, &__yield_generator_awaiter::__next}
+            // Owning the generator destroys its frame with the producer's.
+            , __gen_((_Gen&&)__g) {
+        }
+
+        bool await_ready() {
+            __it_ = __gen_.begin();
+            return __it_ == __gen_.end();
+        }
+
+        template <typename _Promise>
+        void await_suspend(std::coroutine_handle<_Promise> __h) {
+            __generator_promise_base& __root = *__h.promise().__root_;
+            __set(__root);
+            __root.__delegate_ = this;
+        }
+
+        void await_resume() {
+            if (__exception_) {
+                std::rethrow_exception(std::move(__exception_));
+            }
+        }
+
+        // Sets __root's value from the nested generator's current value,
+        // read in place rather than through the iterator, which returns a
+        // copy when the nested reference type is not a reference. A value
+        // the nested generator owns is moved from, as by take().
+        void __set(__generator_promise_base& __root) {
+            using __nested_ref = typename _Gen::iterator::reference;
+            auto& __value = __gen_.__get_promise()->__value_;
+            if constexpr (std::is_reference_v<__nested_ref>) {
+                __root.__value_.__set(static_cast<__nested_ref>(__value.get()));
+            } else if constexpr (std::is_copy_constructible_v<__nested_ref>) {
+                if (__value.__movable()) {
+                    __root.__value_.__set(std::move(__value.get()));
+                } else {
+                    __root.__value_.__set(std::as_const(__value.get()));
+                }
+            } else {
+                __root.__value_.__set(std::move(__value.get()));
+            }
+        }
+
+        static bool __next(__delegate* __d, __generator_promise_base& __root) noexcept {
+            __yield_generator_awaiter& __self = *static_cast<__yield_generator_awaiter*>(__d);
+            try {
+                if (++__self.__it_ == __self.__gen_.end()) {
+                    return false;
+                }
+                __self.__set(__root);
+                return true;
+            } catch (...) {
+                __self.__exception_ = std::current_exception();
+                return false;
+            }
+        }
+    };
+
+    template <typename _ORef, typename _OValue, typename _OAlloc, typename _Allocator>
+        requires __convertible_generator<generator<_ORef, _OValue, _OAlloc>, _Ref>
+    __yield_generator_awaiter<generator<_ORef, _OValue, _OAlloc>>
+    yield_value(std::ranges::elements_of<generator<_ORef, _OValue, _OAlloc>, _Allocator> && __g) noexcept {
+        return __yield_generator_awaiter<generator<_ORef, _OValue, _OAlloc>>{__g.get()};
+    }
+
+    // Lets the consumer walk a range yielded via elements_of() directly.
+    // The awaiter lives in the producer's frame while it is suspended and
+    // registers itself as the root's delegate. Control only returns to the
+    // producer once the range is exhausted.
+    template <typename _Rng>
+    struct __yield_contiguous_awaiter : __delegate {
+        explicit __yield_contiguous_awaiter(_Rng& __rng)
+            : __delegate{std::ranges::data(__rng),
+                         std::ranges::data(__rng) + std::ranges::size(__rng),
+                         nullptr} {
         }
 
         bool await_ready() noexcept {
-            return false;
+            return this->__cur_ == this->__end_;
         }
 
-        // set the parent, root and exceptions pointer and
-        // resume the nested
-        template<typename _Promise>
-        std::coroutine_handle<>
-        await_suspend(std::coroutine_handle<_Promise> __h) noexcept {
-            __generator_promise_base& __current = __h.promise();
-            __generator_promise_base& __nested = *__gen_.__get_promise();
-            __generator_promise_base& __root = *__current.__root_;
+        template <typename _Promise>
+        void await_suspend(std::coroutine_handle<_Promise> __h) noexcept {
+            __generator_promise_base& __root = *__h.promise().__root_;
+            __root.__value_.__set(*this->__cur_++);
+            __root.__delegate_ = this;
+        }
 
-            __nested.__root_ = __current.__root_;
-            __nested.__parentOrLeaf_ = __h;
+        void await_resume() noexcept {}
+    };
 
-            // Lazily construct the __exception_ member here now that we
-            // know it will be used as a nested generator. This will be
-            // destroyed by the promise destructor.
-            __nested.__exception_.construct();
-            __root.__parentOrLeaf_ = __gen_.__get_coro();
+    template <typename _Rng>
+    struct __yield_range_awaiter : __delegate {
+        std::ranges::iterator_t<_Rng> __it_;
+        std::ranges::sentinel_t<_Rng> __end_;
 
-            // Immediately resume the nested coroutine (nested generator)
-            return __gen_.__get_coro();
+        explicit __yield_range_awaiter(_Rng& __rng)
+            : __delegate{nullptr, nullptr, &__yield_range_awaiter::__next}
+            , __it_(std::ranges::begin(__rng))
+            , __end_(std::ranges::end(__rng)) {
         }
 
-        void await_resume() {
-            __generator_promise_base& __nestedPromise = *__gen_.__get_promise();
-            if (__nestedPromise.__exception_.get()) {
-                std::rethrow_exception(std::move(__nestedPromise.__exception_.get()));
+        bool await_ready() noexcept {
+            return __it_ == __end_;
+        }
+
+        template <typename _Promise>
+        void await_suspend(std::coroutine_handle<_Promise> __h) noexcept {
+            __generator_promise_base& __root = *__h.promise().__root_;
+            __root.__value_.__set(*__it_);
+            __root.__delegate_ = this;
+        }
+
+        void await_resume() noexcept {}
+
+        static bool __next(__delegate* __d, __generator_promise_base& __root) noexcept {
+            __yield_range_awaiter& __self = *static_cast<__yield_range_awaiter*>(__d);
+            if (++__self.__it_ == __self.__end_) {
+                return false;
             }
+            __root.__value_.__set(*__self.__it_);
+            return true;
         }
     };
 
-    template <typename _OValue, typename _OAlloc>
-    __yield_sequence_awaiter<generator<_Ref, _OValue, _OAlloc>>
-    yield_value(std::ranges::elements_of<generator<_Ref, _OValue, _OAlloc>> __g) noexcept {
-        return std::move(__g).get();
+    template <std::ranges::range _Rng, typename _Allocator>
+        requires __delegatable_range<_Rng, _Ref>
+    __yield_range_awaiter<std::remove_reference_t<_Rng>>
+    yield_value(std::ranges::elements_of<_Rng, _Allocator> && __x) {
+        auto&& __rng = __x.get();
+        return __yield_range_awaiter<std::remove_reference_t<_Rng>>{__rng};
+    }
+
+    template <std::ranges::range _Rng, typename _Allocator>
+        requires __delegatable_range<_Rng, _Ref> && __contiguous_range_of<_Rng, __element_t>
+    __yield_contiguous_awaiter<std::remove_reference_t<_Rng>>
+    yield_value(std::ranges::elements_of<_Rng, _Allocator> && __x) {
+        auto&& __rng = __x.get();
+        return __yield_contiguous_awaiter<std::remove_reference_t<_Rng>>{__rng};
     }
 
     template <std::ranges::range _Rng, typename _Allocator>
@@ -475,7 +962,130 @@ struct __generator_promise_base
     }
 
     void resume() {
+        __generator_instrumentation::__on_resume();
+        if (__delegate_ != nullptr) {
+            // Only ranges whose elements convert to _Ref are walked by
+            // pointer.
+            if constexpr (std::is_constructible_v<_Ref, __element_t&>) {
+                if (__delegate_->__cur_ != __delegate_->__end_) {
+                    __value_.__set(*__delegate_->__cur_++);
+                    return;
+                }
+            }
+            if (__delegate_->__next_ != nullptr && __delegate_->__next_(__delegate_, *this)) {
+                return;
+            }
+            __delegate_ = nullptr;
+        }
+        __generator_trace::__on_resume(__parentOrLeaf_.address(), *this);
         __parentOrLeaf_.resume();
+        __generator_trace::__on_suspend(__parentOrLeaf_.address(), *this);
+    }
+
+    // Runs the root coroutine __coro up to its first yield.
+    void __start(std::coroutine_handle<> __coro) {
+        __generator_instrumentation::__on_resume();
+        __generator_trace::__on_resume(__coro.address(), *this);
+        __coro.resume();
+        __generator_trace::__on_suspend(__parentOrLeaf_.address(), *this);
+    }
+
+    // Returns the current value as a _Value. Moves from it if the promise
+    // owns it or _Ref is an rvalue reference, and copies otherwise.
+    template <typename _Value>
+    _Value __take() {
+        if constexpr (std::is_rvalue_reference_v<_Ref>) {
+            return _Value(static_cast<_Ref>(__value_.get()));
+        } else if constexpr (std::is_lvalue_reference_v<_Ref>) {
+            return _Value(__value_.get());
+        } else if constexpr (std::is_copy_constructible_v<_Ref>) {
+            if (__value_.__movable()) {
+                return _Value(std::move(__value_.get()));
+            }
+            return _Value(__value_.get());
+        } else {
+            return _Value(std::move(__value_.get()));
+        }
+    }
+
+    // Moves the current and all remaining values of the root coroutine
+    // __coro into __out, starting it first if __started is false.
+    template <typename _Container>
+    void __drain_into(std::coroutine_handle<> __coro, bool __started, _Container& __out) {
+        if (!__started) {
+            __start(__coro);
+        }
+        while (!__coro.done()) {
+            if (__size_hint_ != 0) {
+                if constexpr (requires { __out.reserve(__out.size() + __size_hint_); }) {
+                    __out.reserve(__out.size() + __size_hint_);
+                }
+                __size_hint_ = 0;
+            }
+
+            if constexpr (std::is_reference_v<_Ref>) {
+                __out.push_back(static_cast<_Ref>(__value_.get()));
+            } else if constexpr (std::is_copy_constructible_v<_Ref>) {
+                if (__value_.__movable()) {
+                    __out.push_back(std::move(__value_.get()));
+                } else {
+                    __out.push_back(__value_.get());
+                }
+            } else {
+                __out.push_back(std::move(__value_.get()));
+            }
+            __value_.destruct();
+
+            // Append the rest of a contiguous range yielded via elements_of()
+            // in one go.
+            if constexpr (std::is_constructible_v<typename _Container::value_type, __element_t&> &&
+                          requires (__element_t* __p) { __out.insert(__out.end(), __p, __p); }) {
+                if (__delegate_ != nullptr && __delegate_->__cur_ != __delegate_->__end_) {
+                    __out.insert(__out.end(), __delegate_->__cur_, __delegate_->__end_);
+                    __delegate_->__cur_ = __delegate_->__end_;
+                }
+            }
+            resume();
+        }
+    }
+
+    // Assigns up to __n of the remaining values of the root coroutine
+    // __coro to __out[0], __out[1], ..., starting it first if __started is
+    // false, and returns how many were assigned.
+    template <typename _Out>
+    std::size_t __fill(std::coroutine_handle<> __coro, bool __started, _Out* __out, std::size_t __n) {
+        if (!__started) {
+            __start(__coro);
+        }
+        std::size_t __count = 0;
+        while (__count != __n && !__coro.done()) {
+            if constexpr (std::is_reference_v<_Ref>) {
+                __out[__count++] = static_cast<_Ref>(__value_.get());
+            } else if constexpr (std::is_copy_constructible_v<_Ref>) {
+                if (__value_.__movable()) {
+                    __out[__count++] = std::move(__value_.get());
+                } else {
+                    __out[__count++] = __value_.get();
+                }
+            } else {
+                __out[__count++] = std::move(__value_.get());
+            }
+            __value_.destruct();
+
+            // Copy as much of a contiguous range yielded via elements_of()
+            // as fits in one go.
+            if constexpr (std::is_assignable_v<_Out&, __element_t&>) {
+                if (__delegate_ != nullptr && __delegate_->__cur_ != __delegate_->__end_) {
+                    const std::size_t __k = std::min<std::size_t>(
+                        __n - __count, __delegate_->__end_ - __delegate_->__cur_);
+                    std::copy(__delegate_->__cur_, __delegate_->__cur_ + __k, __out + __count);
+                    __delegate_->__cur_ += __k;
+                    __count += __k;
+                }
+            }
+            resume();
+        }
+        return __count;
     }
 
     // Disable use of co_await within this coroutine.
@@ -489,9 +1099,19 @@ template<typename _Ref, typename _Value, typename _Alloc, typename _ByteAllocato
 struct __generator_promise<generator<_Ref, _Value, _Alloc>, _ByteAllocator, _ExplicitAllocator> final
     : public __generator_promise_base<_Ref>
     , public __promise_base_alloc<_ByteAllocator> {
+#if defined(STDGENERATOR_FRAME_REGISTRY)
+    // The default argument is evaluated in the coroutine, so __where names
+    // the coroutine function.
+    __generator_promise(std::source_location __where = std::source_location::current()) noexcept
+    : __generator_promise_base<_Ref>(std::coroutine_handle<__generator_promise>::from_promise(*this))
+    {
+        this->__frame_.template __register<__generator_promise>(__where);
+    }
+#else
     __generator_promise() noexcept
     : __generator_promise_base<_Ref>(std::coroutine_handle<__generator_promise>::from_promise(*this))
     {}
+#endif
 
     generator<_Ref, _Value, _Alloc> get_return_object() noexcept {
         return generator<_Ref, _Value, _Alloc>{
@@ -501,7 +1121,10 @@ struct __generator_promise<generator<_Ref, _Value, _Alloc>, _ByteAllocator, _Exp
 
     using __generator_promise_base<_Ref>::yield_value;
 
+    // Ranges that can be delegated to, and generators of a convertible
+    // reference type, are handled by the base class and need no allocator.
     template <std::ranges::range _Rng>
+        requires (!__delegatable_range<_Rng, _Ref>) && (!__convertible_generator<_Rng, _Ref>)
     typename __generator_promise_base<_Ref>::template __yield_sequence_awaiter<generator<_Ref, _Value, _Alloc>>
     yield_value(std::ranges::elements_of<_Rng> && __x) {
         static_assert (!_ExplicitAllocator,
@@ -619,6 +1242,7 @@ public:
 
         iterator &operator++() {
             __coro_.promise().__value_.destruct();
+            typename promise_type::__resume_guard __guard{__coro_.promise()};
             __coro_.promise().resume();
             return *this;
         }
@@ -630,6 +1254,28 @@ public:
             return static_cast<reference>(__coro_.promise().__value_.get());
         }
 
+        // Returns the current value, moved out of the generator where it
+        // owns the value or reference is an rvalue reference. The iterator
+        // must be incremented before the value is read again.
+        value_type take() {
+            return __coro_.promise().template __take<value_type>();
+        }
+
+        // Advances to the first value not less than __key, or to the end.
+        // Producers that yield with std::ranges::seekable can jump there
+        // directly; for others this is equivalent to incrementing until
+        // then.
+        iterator& skip_to(const std::remove_cvref_t<reference>& __key) {
+            typename promise_type::__resume_guard __guard{__coro_.promise()};
+            __coro_.promise().__skip_to(__coro_, __key);
+            return *this;
+        }
+
+        // The current value, read in place by combinators such as merge().
+        const std::remove_reference_t<_Ref>& __peek() const noexcept {
+            return __coro_.promise().__value_.get();
+        }
+
       private:
         friend generator;
 
@@ -643,7 +1289,8 @@ public:
         assert(__coro_);
         assert(!__started_);
         __started_ = true;
-        __coro_.resume();
+        typename promise_type::__resume_guard __guard{__coro_.promise()};
+        __coro_.promise().__start(__coro_);
         return iterator{__coro_};
     }
 
@@ -651,6 +1298,33 @@ public:
         return {};
     }
 
+    // Appends the remaining values to __out with push_back(), without
+    // going through the iterator. Values are moved out of the generator
+    // where _Ref allows. Storage is reserved ahead of time if the producer
+    // yields a std::ranges::size_hint and __out has reserve().
+    template <typename _Container>
+    _Container& drain_into(_Container& __out) {
+        assert(__coro_);
+        typename promise_type::__resume_guard __guard{__coro_.promise()};
+        __coro_.promise().__drain_into(__coro_, std::exchange(__started_, true), __out);
+        return __out;
+    }
+
+    // Moves up to __n of the remaining values into __out[0], ... without
+    // going through the iterator, and returns how many there were. Used by
+    // batch().
+    template <typename _Out>
+    std::size_t __fill(_Out* __out, std::size_t __n) {
+        assert(__coro_);
+        typename promise_type::__resume_guard __guard{__coro_.promise()};
+        return __coro_.promise().__fill(__coro_, std::exchange(__started_, true), __out, __n);
+    }
+
+    // Bytes allocated for the coroutine frame; see frame_size().
+    std::size_t __frame_size() const noexcept {
+        return __coro_ ? __coro_.promise().__frame_.__size() : 0;
+    }
+
 private:
     explicit generator(__coroutine_handle __coro) noexcept
         : __coro_(__coro) {
@@ -747,6 +1421,19 @@ public:
             return static_cast<reference>(__promise_->__value_.get());
         }
 
+        value_type take() {
+            return __promise_->template __take<value_type>();
+        }
+
+        iterator& skip_to(const std::remove_cvref_t<reference>& __key) {
+            __promise_->__skip_to(__coro_, __key);
+            return *this;
+        }
+
+        const std::remove_reference_t<_Ref>& __peek() const noexcept {
+            return __promise_->__value_.get();
+        }
+
       private:
         friend generator;
 
@@ -763,7 +1450,7 @@ public:
         assert(__coro_);
         assert(!__started_);
         __started_ = true;
-        __coro_.resume();
+        __promise_->__start(__coro_);
         return iterator{__promise_, __coro_};
     }
 
@@ -771,6 +1458,23 @@ public:
         return {};
     }
 
+    template <typename _Container>
+    _Container& drain_into(_Container& __out) {
+        assert(__coro_);
+        __promise_->__drain_into(__coro_, std::exchange(__started_, true), __out);
+        return __out;
+    }
+
+    template <typename _Out>
+    std::size_t __fill(_Out* __out, std::size_t __n) {
+        assert(__coro_);
+        return __promise_->__fill(__coro_, std::exchange(__started_, true), __out, __n);
+    }
+
+    std::size_t __frame_size() const noexcept {
+        return __coro_ ? __promise_->__frame_.__size() : 0;
+    }
+
 private:
     template<typename _Generator, typename _ByteAllocator, bool _ExplicitAllocator>
     friend struct __generator_promise;
@@ -791,6 +1495,25 @@ private:
     bool __started_ = false;
 };
 
+#if __has_include(<memory_resource>)
+namespace pmr {
+
+// Generator whose frames are allocated from the memory resource passed
+// after std::allocator_arg, or from the default resource.
+//
+// Without optimisation, GCC (12 and later) reports -Wmismatched-new-delete
+// for coroutines passed std::allocator_arg, as for any generator with a
+// stored allocator. The frame's operator new is a template over the
+// coroutine's parameters. GCC does not pair it with the class's sized
+// operator delete, which cannot be a template. The pairing is correct.
+// Builds that use -Werror with GCC at -O0 need -Wno-mismatched-new-delete
+// around such coroutines.
+__STDGENERATOR_EXPORT template <typename _Ref, typename _Value = std::remove_cvref_t<_Ref>>
+using generator = std::generator<_Ref, _Value, std::pmr::polymorphic_allocator<>>;
+
+} // namespace pmr
+#endif
+
 #if __has_include(<ranges>)
 namespace ranges {
 
@@ -0,0 +1,168 @@
+#ifndef __STD_GENERATOR_FRAME_RESOURCE_INCLUDED
+#define __STD_GENERATOR_FRAME_RESOURCE_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// generator_frame_resource: a std::pmr::memory_resource for the frames of
+// std::pmr::generator coroutines.
+//
+// Generators allocate frames of a handful of distinct sizes (one per
+// coroutine function) at a high rate, and a tree of nested generators frees
+// them in roughly the reverse order of allocation. The resource keeps one
+// free list per size class, so that a frame is usually placed in the
+// memory of the frame of the same size freed most recently, which is still
+// in cache. Blocks for a size class with an empty free list are carved
+// from chunks obtained from the upstream resource, which double in size up
+// to __max_chunk_size, so nested frames created one after another sit next
+// to each other. Unlike std::pmr pool resources there is no per-chunk
+// bookkeeping: allocation and deallocation are a free-list pop and push.
+//
+// Requests larger than __max_binned_size or with alignment stricter than
+// __STDCPP_DEFAULT_NEW_ALIGNMENT__ are forwarded to the upstream resource.
+// Memory carved from chunks is returned upstream only by release() or the
+// destructor, after all frames allocated from it have been destroyed.
+//
+// Not thread-safe: like std::pmr::unsynchronized_pool_resource, a resource
+// must only be used by one thread at a time.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+namespace std::experimental {
+
+class generator_frame_resource final : public std::pmr::memory_resource {
+public:
+    // Block sizes are rounded up to a multiple of the granularity.
+    static constexpr std::size_t __granularity = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static constexpr std::size_t __max_binned_size = 2048;
+    static constexpr std::size_t __class_count = __max_binned_size / __granularity;
+
+    static constexpr std::size_t __initial_chunk_size = 4096;
+    static constexpr std::size_t __max_chunk_size = 1024 * 1024;
+
+    generator_frame_resource() noexcept
+        : generator_frame_resource(std::pmr::get_default_resource()) {}
+
+    explicit generator_frame_resource(std::pmr::memory_resource* __upstream) noexcept
+        : __upstream_(__upstream) {}
+
+    generator_frame_resource(const generator_frame_resource&) = delete;
+    generator_frame_resource& operator=(const generator_frame_resource&) = delete;
+
+    ~generator_frame_resource() override {
+        release();
+    }
+
+    // Returns all chunks to the upstream resource.
+    void release() noexcept {
+        while (__chunk* __c = __chunks_) {
+            __chunks_ = __c->__next_;
+            __upstream_->deallocate(__c, __c->__size_, __granularity);
+        }
+        std::fill(std::begin(__free_), std::end(__free_), nullptr);
+        __cur_ = __end_ = nullptr;
+        __next_chunk_size_ = __initial_chunk_size;
+    }
+
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return __upstream_;
+    }
+
+protected:
+    void* do_allocate(std::size_t __bytes, std::size_t __alignment) override {
+        if (__bytes > __max_binned_size || __alignment > __granularity) [[unlikely]] {
+            return __upstream_->allocate(__bytes, __alignment);
+        }
+        const std::size_t __cls = __size_class(__bytes);
+        if (__free_block* __b = __free_[__cls]) {
+            __free_[__cls] = __b->__next_;
+            return __b;
+        }
+        const std::size_t __size = __block_size(__cls);
+        if (static_cast<std::size_t>(__end_ - __cur_) < __size) {
+            __grow(__size);
+        }
+        void* __ptr = __cur_;
+        __cur_ += __size;
+        return __ptr;
+    }
+
+    void do_deallocate(void* __ptr, std::size_t __bytes, std::size_t __alignment) override {
+        if (__bytes > __max_binned_size || __alignment > __granularity) [[unlikely]] {
+            __upstream_->deallocate(__ptr, __bytes, __alignment);
+            return;
+        }
+        __push(__size_class(__bytes), __ptr);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& __other) const noexcept override {
+        return this == &__other;
+    }
+
+private:
+    // Free blocks reuse their first word as the list link.
+    struct __free_block {
+        __free_block* __next_;
+    };
+
+    // Prefix of every chunk obtained from upstream.
+    struct alignas(__granularity) __chunk {
+        __chunk* __next_;
+        std::size_t __size_;
+    };
+
+    static constexpr std::size_t __size_class(std::size_t __bytes) noexcept {
+        return __bytes == 0 ? 0 : (__bytes - 1) / __granularity;
+    }
+
+    static constexpr std::size_t __block_size(std::size_t __cls) noexcept {
+        return (__cls + 1) * __granularity;
+    }
+
+    void __push(std::size_t __cls, void* __ptr) noexcept {
+        __free_block* __b = static_cast<__free_block*>(__ptr);
+        __b->__next_ = __free_[__cls];
+        __free_[__cls] = __b;
+    }
+
+    // Starts a new chunk with room for at least __size bytes.
+    void __grow(std::size_t __size) {
+        const std::size_t __chunk_size =
+            std::max(__next_chunk_size_, sizeof(__chunk) + __size);
+        __chunk* __c = static_cast<__chunk*>(__upstream_->allocate(__chunk_size, __granularity));
+        __c->__next_ = __chunks_;
+        __c->__size_ = __chunk_size;
+        __chunks_ = __c;
+        __next_chunk_size_ = std::min(__next_chunk_size_ * 2, __max_chunk_size);
+
+        // The rest of the previous chunk becomes a free block of its size.
+        if (const std::size_t __rest = static_cast<std::size_t>(__end_ - __cur_); __rest != 0) {
+            __push(__size_class(__rest), __cur_);
+        }
+        __cur_ = reinterpret_cast<char*>(__c + 1);
+        __end_ = reinterpret_cast<char*>(__c) + __chunk_size;
+    }
+
+    __free_block* __free_[__class_count] = {};
+    // Unused part of the newest chunk.
+    char* __cur_ = nullptr;
+    char* __end_ = nullptr;
+    __chunk* __chunks_ = nullptr;
+    std::size_t __next_chunk_size_ = __initial_chunk_size;
+    std::pmr::memory_resource* __upstream_;
+};
+
+} // namespace std::experimental
+
+#endif // __STD_GENERATOR_FRAME_RESOURCE_INCLUDED
@@ -0,0 +1,296 @@
+#ifndef __STD_GENERATOR_FRAMES_INCLUDED
+#define __STD_GENERATOR_FRAMES_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// Opt-in registry of generator coroutine frame sizes.
+//
+// Compiling with STDGENERATOR_FRAME_REGISTRY defined makes every generator
+// record the size of its frame against its call site: the promise type
+// together with the coroutine function, file and line, as reported by
+// std::source_location. Each call site counts the frames allocated for it
+// and how many of them are still live.
+//
+// frame_size(gen) returns the size of the frame of one generator.
+// generator_frame_report() returns one entry per call site, largest
+// frames first, and write_generator_frame_report() prints them as a table.
+// A frame much larger than its neighbours usually holds a large local
+// variable across a co_yield.
+//
+// The size is the number of bytes the frame's allocator was asked for,
+// including an allocator stored in the frame; it is 0 if the compiler
+// elided the allocation. Registration takes a lock only the first time a
+// thread sees a call site.
+//
+// Without STDGENERATOR_FRAME_REGISTRY, frame_size() returns 0 and the
+// report is empty.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#if defined(STDGENERATOR_FRAME_REGISTRY)
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+#endif
+
+namespace std {
+
+namespace experimental {
+
+inline constexpr bool generator_frame_registry_enabled =
+#if defined(STDGENERATOR_FRAME_REGISTRY)
+    true;
+#else
+    false;
+#endif
+
+// Frames allocated at one call site. The strings live as long as the
+// program.
+struct generator_frame_info {
+    // Demangled name of the promise type.
+    const char* promise_type;
+    // Coroutine function, and the file and line it is defined at.
+    const char* function;
+    const char* file;
+    std::uint_least32_t line;
+    // Bytes allocated per frame.
+    std::size_t frame_size;
+    // Frames currently alive, and frames allocated since the program
+    // started.
+    std::size_t live_frames;
+    std::size_t frames_allocated;
+};
+
+} // namespace experimental
+
+#if defined(STDGENERATOR_FRAME_REGISTRY)
+
+struct __generator_frame_site {
+    __generator_frame_site(const std::type_info& __type, const std::source_location& __where,
+                           std::size_t __size)
+        : __type_(&__type)
+        , __where_(__where)
+        , __size_(__size)
+        , __type_name_(__demangle(__type)) {}
+
+    bool __matches(const std::type_info& __type, const std::source_location& __where,
+                   std::size_t __size) const noexcept {
+        return __size_ == __size && __where_.line() == __where.line() &&
+               *__type_ == __type &&
+               (__where_.function_name() == __where.function_name() ||
+                std::strcmp(__where_.function_name(), __where.function_name()) == 0) &&
+               (__where_.file_name() == __where.file_name() ||
+                std::strcmp(__where_.file_name(), __where.file_name()) == 0);
+    }
+
+    static std::string __demangle(const std::type_info& __type) {
+#if __has_include(<cxxabi.h>)
+        int __status = 0;
+        char* __name = abi::__cxa_demangle(__type.name(), nullptr, nullptr, &__status);
+        if (__name != nullptr) {
+            std::string __result(__name);
+            std::free(__name);
+            return __result;
+        }
+#endif
+        return __type.name();
+    }
+
+    const std::type_info* __type_;
+    std::source_location __where_;
+    std::size_t __size_;
+    std::string __type_name_;
+    std::atomic<std::size_t> __live_{0};
+    std::atomic<std::size_t> __allocated_{0};
+};
+
+struct __generator_frames {
+    struct __registry {
+        std::mutex __mutex_;
+        // A deque, so that sites do not move as more are added.
+        std::deque<__generator_frame_site> __sites_;
+    };
+
+    static __registry& __get_registry() {
+        static __registry __r;
+        return __r;
+    }
+
+    // Size of the most recent frame allocation on this thread. Read by the
+    // promise constructor that immediately follows the allocation.
+    static inline thread_local std::size_t __last_size_ = 0;
+
+    static void __on_allocate(std::size_t __size) noexcept {
+        __last_size_ = __size;
+    }
+
+    // Called by promises that do not register their frame, so that the
+    // size of their allocation is not read by the next one that does.
+    static void __discard_allocation() noexcept {
+        __last_size_ = 0;
+    }
+
+    // Returns the site for a frame of __size bytes, or nullptr if it could
+    // not be recorded.
+    static __generator_frame_site* __site(const std::type_info& __type,
+                                          const std::source_location& __where,
+                                          std::size_t __size) noexcept {
+        // Sites this thread has seen, indexed by a hash of the call site.
+        static thread_local __generator_frame_site* __cache[64] = {};
+        const std::size_t __slot =
+            (reinterpret_cast<std::uintptr_t>(__where.function_name()) / 8 ^ __where.line() ^ __size) % 64;
+        __generator_frame_site* __s = __cache[__slot];
+        if (__s != nullptr && __s->__matches(__type, __where, __size)) [[likely]] {
+            return __s;
+        }
+        __s = __find(__type, __where, __size);
+        __cache[__slot] = __s;
+        return __s;
+    }
+
+    static __generator_frame_site* __find(const std::type_info& __type,
+                                          const std::source_location& __where,
+                                          std::size_t __size) noexcept {
+        __registry& __r = __get_registry();
+        std::lock_guard<std::mutex> __lock(__r.__mutex_);
+        for (__generator_frame_site& __s : __r.__sites_) {
+            if (__s.__matches(__type, __where, __size)) {
+                return &__s;
+            }
+        }
+        try {
+            return &__r.__sites_.emplace_back(__type, __where, __size);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+};
+
+// Held by each promise; counts its frame against its call site.
+class __generator_frame_handle {
+public:
+    __generator_frame_handle() noexcept = default;
+    __generator_frame_handle(const __generator_frame_handle&) = delete;
+    __generator_frame_handle& operator=(const __generator_frame_handle&) = delete;
+
+    ~__generator_frame_handle() {
+        if (__site_ != nullptr) {
+            __site_->__live_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename _Promise>
+    void __register(const std::source_location& __where) noexcept {
+        // Reset so that a frame whose allocation was elided reads as 0
+        // rather than as the size of an earlier frame.
+        const std::size_t __size = std::exchange(__generator_frames::__last_size_, 0);
+        __site_ = __generator_frames::__site(typeid(_Promise), __where, __size);
+        if (__site_ != nullptr) {
+            __site_->__allocated_.fetch_add(1, std::memory_order_relaxed);
+            __site_->__live_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t __size() const noexcept {
+        return __site_ != nullptr ? __site_->__size_ : 0;
+    }
+
+private:
+    __generator_frame_site* __site_ = nullptr;
+};
+
+#else
+
+struct __generator_frames {
+    static void __on_allocate(std::size_t) noexcept {}
+    static void __discard_allocation() noexcept {}
+};
+
+struct __generator_frame_handle {
+    std::size_t __size() const noexcept {
+        return 0;
+    }
+};
+
+#endif
+
+namespace experimental {
+
+// Bytes allocated for the frame of the coroutine __gen refers to, or 0 if
+// it refers to none.
+template <typename _Generator>
+    requires requires(const _Generator& __gen) { __gen.__frame_size(); }
+std::size_t frame_size(const _Generator& __gen) noexcept {
+    return __gen.__frame_size();
+}
+
+// One entry per call site that has allocated a frame, ordered by frame
+// size, largest first, then by number of live frames.
+inline std::vector<generator_frame_info> generator_frame_report() {
+    std::vector<generator_frame_info> __report;
+#if defined(STDGENERATOR_FRAME_REGISTRY)
+    auto& __r = __generator_frames::__get_registry();
+    {
+        std::lock_guard<std::mutex> __lock(__r.__mutex_);
+        __report.reserve(__r.__sites_.size());
+        for (const __generator_frame_site& __s : __r.__sites_) {
+            __report.push_back({__s.__type_name_.c_str(), __s.__where_.function_name(),
+                                __s.__where_.file_name(), __s.__where_.line(), __s.__size_,
+                                __s.__live_.load(std::memory_order_relaxed),
+                                __s.__allocated_.load(std::memory_order_relaxed)});
+        }
+    }
+    std::stable_sort(__report.begin(), __report.end(),
+                     [](const generator_frame_info& __a, const generator_frame_info& __b) {
+                         if (__a.frame_size != __b.frame_size) {
+                             return __a.frame_size > __b.frame_size;
+                         }
+                         return __a.live_frames > __b.live_frames;
+                     });
+#endif
+    return __report;
+}
+
+// Writes generator_frame_report() as a table with one line per call site.
+template <typename _CharT, typename _Traits>
+void write_generator_frame_report(std::basic_ostream<_CharT, _Traits>& __out) {
+#if defined(STDGENERATOR_FRAME_REGISTRY)
+    __out << "frame bytes       live  allocated  call site\n";
+    for (const generator_frame_info& __info : generator_frame_report()) {
+        __out << std::setw(11) << __info.frame_size << ' ' << std::setw(10) << __info.live_frames
+              << ' ' << std::setw(10) << __info.frames_allocated << "  " << __info.function << " ("
+              << __info.file << ':' << __info.line << ")\n"
+              << std::setw(35) << "" << __info.promise_type << '\n';
+    }
+#else
+    (void)__out;
+#endif
+}
+
+} // namespace experimental
+
+} // namespace std
+
+#endif // __STD_GENERATOR_FRAMES_INCLUDED
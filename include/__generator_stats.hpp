@@ -0,0 +1,150 @@
+#ifndef __STD_GENERATOR_STATS_INCLUDED
+#define __STD_GENERATOR_STATS_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// Opt-in per-thread counters for generator coroutines.
+//
+// Compiling with STDGENERATOR_INSTRUMENTATION defined makes generators
+// count, on the thread doing the work, how often consumers resume them,
+// how many frames and frame bytes they allocate, how often values are
+// handed over from nested generators and how many exceptions are carried
+// from a nested generator to its parent. It also records the deepest
+// nesting seen. Read the counters with this_thread_generator_stats().
+//
+// Without STDGENERATOR_INSTRUMENTATION the hooks are empty and the
+// counters read as zero.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+namespace std {
+
+namespace experimental {
+
+struct generator_stats {
+    static constexpr bool enabled =
+#if defined(STDGENERATOR_INSTRUMENTATION)
+        true;
+#else
+        false;
+#endif
+
+    // Calls to begin() and iterator::operator++, plus resumptions made by
+    // drain_into().
+    std::size_t resumes = 0;
+    // Coroutine frames allocated and freed, and bytes allocated for them.
+    std::size_t frames_allocated = 0;
+    std::size_t frames_freed = 0;
+    std::size_t frame_bytes_allocated = 0;
+    // Generators entered via co_yield elements_of(generator), and nested
+    // generators that completed and handed control back to their parent.
+    std::size_t nested_entries = 0;
+    std::size_t nested_exits = 0;
+    // Exceptions that escaped a nested generator into its parent.
+    std::size_t exceptions_transferred = 0;
+    // Deepest nesting seen below a root generator; 0 if nothing was nested.
+    std::size_t max_depth = 0;
+};
+
+} // namespace experimental
+
+#if defined(STDGENERATOR_INSTRUMENTATION) || defined(STDGENERATOR_TRACING)
+
+// Nesting depth of a generator below its root and, on a root, the depth of
+// its current leaf. Empty unless instrumentation or tracing is enabled.
+struct __generator_depth {
+    std::size_t __depth_ = 0;
+    std::size_t __leaf_depth_ = 0;
+
+    void __enter(__generator_depth& __nested, __generator_depth& __root) noexcept {
+        __nested.__depth_ = __depth_ + 1;
+        __root.__leaf_depth_ = __nested.__depth_;
+    }
+
+    void __exit(__generator_depth& __root) noexcept {
+        __root.__leaf_depth_ = __depth_ - 1;
+    }
+};
+
+#else
+
+struct __generator_depth {
+    void __enter(__generator_depth&, __generator_depth&) noexcept {}
+    void __exit(__generator_depth&) noexcept {}
+};
+
+#endif
+
+#if defined(STDGENERATOR_INSTRUMENTATION)
+
+struct __generator_instrumentation {
+    static inline thread_local experimental::generator_stats __stats_;
+
+    static void __on_resume() noexcept {
+        ++__stats_.resumes;
+    }
+
+    static void __on_allocate(std::size_t __size) noexcept {
+        ++__stats_.frames_allocated;
+        __stats_.frame_bytes_allocated += __size;
+    }
+
+    static void __on_deallocate() noexcept {
+        ++__stats_.frames_freed;
+    }
+
+    static void __on_nested_entry(const __generator_depth& __nested) noexcept {
+        ++__stats_.nested_entries;
+        if (__nested.__depth_ > __stats_.max_depth) {
+            __stats_.max_depth = __nested.__depth_;
+        }
+    }
+
+    static void __on_nested_exit(bool __threw) noexcept {
+        ++__stats_.nested_exits;
+        __stats_.exceptions_transferred += __threw;
+    }
+};
+
+#else
+
+struct __generator_instrumentation {
+    static void __on_resume() noexcept {}
+    static void __on_allocate(std::size_t) noexcept {}
+    static void __on_deallocate() noexcept {}
+    static void __on_nested_entry(const __generator_depth&) noexcept {}
+    static void __on_nested_exit(bool) noexcept {}
+};
+
+#endif
+
+namespace experimental {
+
+// Counters accumulated on the calling thread since it started or since the
+// last reset_this_thread_generator_stats().
+inline generator_stats this_thread_generator_stats() noexcept {
+#if defined(STDGENERATOR_INSTRUMENTATION)
+    return __generator_instrumentation::__stats_;
+#else
+    return {};
+#endif
+}
+
+inline void reset_this_thread_generator_stats() noexcept {
+#if defined(STDGENERATOR_INSTRUMENTATION)
+    __generator_instrumentation::__stats_ = {};
+#endif
+}
+
+} // namespace experimental
+
+} // namespace std
+
+#endif // __STD_GENERATOR_STATS_INCLUDED
@@ -0,0 +1,238 @@
+#ifndef __STD_GENERATOR_TRACE_INCLUDED
+#define __STD_GENERATOR_TRACE_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// Opt-in timeline tracing of generator coroutines.
+//
+// Compiling with STDGENERATOR_TRACING defined makes generators record an
+// event each time control changes hands inside a generator tree:
+//
+//  - resume:  the consumer resumes the current leaf coroutine;
+//  - suspend: control returns to the consumer, after a yield or once the
+//             root completes;
+//  - enter:   a nested generator is entered via elements_of;
+//  - exit:    a nested generator completes and returns to its parent.
+//
+// Each event holds a timestamp, the address of the coroutine frame involved
+// and its nesting depth below the root. Values pulled straight from a range
+// yielded via elements_of do not change hands and are not recorded.
+//
+// Events go to a fixed-size ring buffer owned by the recording thread, so
+// recording takes no locks and never allocates after a thread's first
+// event; when a ring is full the oldest events are overwritten.
+// write_generator_trace() writes the rings of all threads as Chrome trace
+// event JSON, which chrome://tracing and Perfetto can open. Call it, and
+// clear_generator_trace(), while no other thread is recording events.
+//
+// Without STDGENERATOR_TRACING the hooks are empty and the trace is empty.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator_stats.hpp>
+
+#include <cstddef>
+#include <iosfwd>
+
+#if defined(STDGENERATOR_TRACING)
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#endif
+
+namespace std {
+
+#if defined(STDGENERATOR_TRACING)
+
+enum class __trace_event_kind : std::uint8_t { __resume, __suspend, __enter, __exit };
+
+struct __trace_event {
+    std::int64_t __time_ns_;
+    const void* __frame_;
+    std::uint32_t __depth_;
+    __trace_event_kind __kind_;
+};
+
+// Events recorded by one thread. Only that thread writes to it.
+class __trace_ring {
+public:
+    static constexpr std::size_t __capacity = std::size_t(1) << 15;
+
+    explicit __trace_ring(std::uint32_t __thread_id) noexcept
+        : __thread_id_(__thread_id) {}
+
+    void __record(__trace_event_kind __kind, const void* __frame, std::size_t __depth) noexcept {
+        const std::uint64_t __n = __written_.load(std::memory_order_relaxed);
+        __events_[__n & (__capacity - 1)] = __trace_event{
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count(),
+            __frame, static_cast<std::uint32_t>(__depth), __kind};
+        __written_.store(__n + 1, std::memory_order_release);
+    }
+
+    template <typename _F>
+    void __for_each(_F&& __f) const {
+        const std::uint64_t __end = __written_.load(std::memory_order_acquire);
+        const std::uint64_t __begin = __end > __capacity ? __end - __capacity : 0;
+        for (std::uint64_t __i = __begin; __i != __end; ++__i) {
+            __f(__events_[__i & (__capacity - 1)]);
+        }
+    }
+
+    void __clear() noexcept {
+        __written_.store(0, std::memory_order_relaxed);
+    }
+
+    std::uint32_t __thread_id() const noexcept {
+        return __thread_id_;
+    }
+
+private:
+    std::atomic<std::uint64_t> __written_{0};
+    const std::uint32_t __thread_id_;
+    __trace_event __events_[__capacity];
+};
+
+struct __generator_trace {
+    // All rings ever created. Rings of threads that have exited stay here
+    // until the next clear_generator_trace().
+    struct __registry {
+        std::mutex __mutex_;
+        std::vector<std::shared_ptr<__trace_ring>> __rings_;
+        std::uint32_t __next_thread_id_ = 1;
+    };
+
+    static __registry& __get_registry() {
+        static __registry __r;
+        return __r;
+    }
+
+    static inline std::atomic<bool> __enabled_{true};
+
+    static __trace_ring& __this_thread_ring() {
+        static thread_local std::shared_ptr<__trace_ring> __ring = [] {
+            __registry& __r = __get_registry();
+            std::lock_guard<std::mutex> __lock(__r.__mutex_);
+            auto __new_ring = std::make_shared<__trace_ring>(__r.__next_thread_id_++);
+            __r.__rings_.push_back(__new_ring);
+            return __new_ring;
+        }();
+        return *__ring;
+    }
+
+    static void __record(__trace_event_kind __kind, const void* __frame, std::size_t __depth) noexcept {
+        if (__enabled_.load(std::memory_order_relaxed)) {
+            try {
+                __this_thread_ring().__record(__kind, __frame, __depth);
+            } catch (...) {
+                // Creating the ring failed; drop the event.
+            }
+        }
+    }
+
+    static void __on_resume(const void* __leaf, const __generator_depth& __root) noexcept {
+        __record(__trace_event_kind::__resume, __leaf, __root.__leaf_depth_);
+    }
+
+    static void __on_suspend(const void* __leaf, const __generator_depth& __root) noexcept {
+        __record(__trace_event_kind::__suspend, __leaf, __root.__leaf_depth_);
+    }
+
+    static void __on_nested_entry(const void* __frame, const __generator_depth& __nested) noexcept {
+        __record(__trace_event_kind::__enter, __frame, __nested.__depth_);
+    }
+
+    static void __on_nested_exit(const void* __frame, const __generator_depth& __nested) noexcept {
+        __record(__trace_event_kind::__exit, __frame, __nested.__depth_);
+    }
+};
+
+#else
+
+struct __generator_trace {
+    static void __on_resume(const void*, const __generator_depth&) noexcept {}
+    static void __on_suspend(const void*, const __generator_depth&) noexcept {}
+    static void __on_nested_entry(const void*, const __generator_depth&) noexcept {}
+    static void __on_nested_exit(const void*, const __generator_depth&) noexcept {}
+};
+
+#endif
+
+namespace experimental {
+
+// Starts or stops recording events. Recording is on by default when
+// compiled with STDGENERATOR_TRACING.
+inline void enable_generator_tracing([[maybe_unused]] bool __enabled) noexcept {
+#if defined(STDGENERATOR_TRACING)
+    __generator_trace::__enabled_.store(__enabled, std::memory_order_relaxed);
+#endif
+}
+
+// Discards all recorded events.
+inline void clear_generator_trace() {
+#if defined(STDGENERATOR_TRACING)
+    auto& __r = __generator_trace::__get_registry();
+    std::lock_guard<std::mutex> __lock(__r.__mutex_);
+    std::erase_if(__r.__rings_, [](const std::shared_ptr<__trace_ring>& __ring) {
+        // Only the registry still refers to rings of exited threads.
+        return __ring.use_count() == 1;
+    });
+    for (auto& __ring : __r.__rings_) {
+        __ring->__clear();
+    }
+#endif
+}
+
+// Writes the recorded events as a Chrome trace event JSON object.
+// Resume/suspend pairs become duration events named "generator"; entering
+// and leaving nested generators become instant events.
+template <typename _CharT, typename _Traits>
+void write_generator_trace(std::basic_ostream<_CharT, _Traits>& __out) {
+    __out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+#if defined(STDGENERATOR_TRACING)
+    auto& __r = __generator_trace::__get_registry();
+    std::lock_guard<std::mutex> __lock(__r.__mutex_);
+    const char* __separator = "\n";
+    for (const auto& __ring : __r.__rings_) {
+        __ring->__for_each([&](const __trace_event& __e) {
+            const char* __name = "generator";
+            const char* __phase = "B";
+            switch (__e.__kind_) {
+            case __trace_event_kind::__resume: break;
+            case __trace_event_kind::__suspend: __phase = "E"; break;
+            case __trace_event_kind::__enter: __name = "enter"; __phase = "i"; break;
+            case __trace_event_kind::__exit: __name = "exit"; __phase = "i"; break;
+            }
+            __out << __separator
+                  << "{\"name\":\"" << __name << "\",\"ph\":\"" << __phase << "\""
+                  << ",\"pid\":1,\"tid\":" << __ring->__thread_id()
+                  << ",\"ts\":" << __e.__time_ns_ / 1000 << '.';
+            const auto __fraction = __e.__time_ns_ % 1000;
+            __out << char('0' + __fraction / 100) << char('0' + __fraction / 10 % 10)
+                  << char('0' + __fraction % 10);
+            if (__phase[0] == 'i') {
+                __out << ",\"s\":\"t\"";
+            }
+            __out << ",\"args\":{\"frame\":\"" << __e.__frame_
+                  << "\",\"depth\":" << __e.__depth_ << "}}";
+            __separator = ",\n";
+        });
+    }
+#endif
+    __out << "\n]}\n";
+}
+
+} // namespace experimental
+
+} // namespace std
+
+#endif // __STD_GENERATOR_TRACE_INCLUDED
@@ -0,0 +1,311 @@
+#ifndef __STD_LIFO_ARENA_INCLUDED
+#define __STD_LIFO_ARENA_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// Per-root LIFO arena for nested generator frames.
+//
+// A generator whose allocator is lifo_arena_allocator allocates its frame
+// from the arena of whichever such generator is currently being resumed on
+// this thread. If none is being resumed, the generator becomes the root of
+// a new arena. Nested generators created by the root's producer, e.g. for
+// a recursive tree walk via elements_of, therefore share the root's arena
+// without threading an allocator through every call.
+//
+// Frames of nested generators are destroyed in the reverse order of their
+// creation, so the arena is a bump allocator that pops from the top. Frames
+// freed out of order are marked and reclaimed when the frames above them
+// are popped. The arena lives until its last frame is freed, so a generator
+// that escapes its root remains valid. All frames of an arena must be
+// created and destroyed on one thread at a time.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace std::experimental {
+
+class alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) __lifo_arena {
+public:
+    static constexpr std::size_t __alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    // Size of the single allocation holding a new arena and its first chunk.
+    // Kept small so that arenas of shallow trees stay cheap to create.
+    static constexpr std::size_t __initial_allocation = 1024;
+    static constexpr std::size_t __max_chunk_capacity = 1024 * 1024;
+
+    // Arena that frames allocated on this thread are placed into.
+    static inline thread_local __lifo_arena* __current_ = nullptr;
+
+    static void* allocate(std::size_t __size) {
+        __lifo_arena* __arena = __current_;
+        if (__arena == nullptr) {
+            __arena = __create();
+            try {
+                return __arena->__allocate(__size);
+            } catch (...) {
+                __arena->__destroy();
+                throw;
+            }
+        }
+        return __arena->__allocate(__size);
+    }
+
+    // Arena of the frame that __object lies in, read from the frame's block
+    // header, or nullptr if that frame is not the most recent allocation on
+    // this thread. Called by the promise constructor, which runs right
+    // after its frame is allocated; if the allocation was elided, the
+    // promise lies outside every block and gets no arena.
+    static __lifo_arena* __arena_containing(const void* __object) noexcept {
+        const std::uintptr_t __address = reinterpret_cast<std::uintptr_t>(__object);
+        if (__address < reinterpret_cast<std::uintptr_t>(__last_frame_) ||
+            __address >= reinterpret_cast<std::uintptr_t>(__last_frame_end_)) {
+            return nullptr;
+        }
+        return (reinterpret_cast<__block*>(__last_frame_) - 1)->__arena_;
+    }
+
+    static void deallocate(void* __ptr, std::size_t) noexcept {
+        __block* __b = static_cast<__block*>(__ptr) - 1;
+        if (__b + 1 == reinterpret_cast<__block*>(__last_frame_)) {
+            __last_frame_ = __last_frame_end_ = nullptr;
+        }
+        __b->__arena_->__release(__b);
+    }
+
+private:
+    // Bounds of the most recent allocation on this thread.
+    static inline thread_local char* __last_frame_ = nullptr;
+    static inline thread_local char* __last_frame_end_ = nullptr;
+
+    struct alignas(__alignment) __block {
+        __lifo_arena* __arena_;
+        // Previous block in allocation order. The low bit is set once this
+        // block has been freed out of order.
+        std::uintptr_t __prev_;
+
+        __block* __previous() const noexcept {
+            return reinterpret_cast<__block*>(__prev_ & ~std::uintptr_t(1));
+        }
+
+        bool __freed() const noexcept {
+            return (__prev_ & 1) != 0;
+        }
+    };
+
+    struct alignas(__alignment) __chunk {
+        __chunk* __prev_;
+        char* __end_;
+        // Top of the previous chunk, restored when this chunk empties.
+        char* __prev_top_;
+
+        char* __data() noexcept {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    static constexpr std::size_t __round_up(std::size_t __size) noexcept {
+        return (__size + __alignment - 1) & ~(__alignment - 1);
+    }
+
+    // The arena and its first chunk share a single allocation.
+    static __lifo_arena* __create() {
+        void* __mem = ::operator new(__initial_allocation);
+        __lifo_arena* __arena = ::new (__mem) __lifo_arena;
+        __chunk* __first = ::new (static_cast<void*>(__arena + 1)) __chunk;
+        __first->__prev_ = nullptr;
+        __first->__end_ = static_cast<char*>(__mem) + __initial_allocation;
+        __first->__prev_top_ = nullptr;
+        __arena->__chunk_ = __first;
+        __arena->__top_ = __first->__data();
+        return __arena;
+    }
+
+    void __destroy() noexcept {
+        while (__chunk_->__prev_ != nullptr) {
+            __chunk* __prev = __chunk_->__prev_;
+            __free_chunk(__chunk_);
+            __chunk_ = __prev;
+        }
+        if (__spare_ != nullptr) {
+            __free_chunk(__spare_);
+        }
+        this->~__lifo_arena();
+        ::operator delete(static_cast<void*>(this), __initial_allocation);
+    }
+
+    static void __free_chunk(__chunk* __c) noexcept {
+        ::operator delete(static_cast<void*>(__c),
+                          static_cast<std::size_t>(__c->__end_ - reinterpret_cast<char*>(__c)));
+    }
+
+    void* __allocate(std::size_t __size) {
+        const std::size_t __needed = sizeof(__block) + __round_up(__size);
+        if (static_cast<std::size_t>(__chunk_->__end_ - __top_) < __needed) {
+            __grow(__needed);
+        }
+
+        __block* __b = reinterpret_cast<__block*>(__top_);
+        __b->__arena_ = this;
+        __b->__prev_ = reinterpret_cast<std::uintptr_t>(__last_block_);
+        __last_block_ = __b;
+        __top_ += __needed;
+        ++__live_;
+        __last_frame_ = reinterpret_cast<char*>(__b + 1);
+        __last_frame_end_ = __top_;
+        return __b + 1;
+    }
+
+    void __grow(std::size_t __needed) {
+        __chunk* __next = __spare_;
+        if (__next == nullptr ||
+            static_cast<std::size_t>(__next->__end_ - __next->__data()) < __needed) {
+            const std::size_t __current =
+                static_cast<std::size_t>(__chunk_->__end_ - reinterpret_cast<char*>(__chunk_));
+            std::size_t __capacity = __current * 2;
+            if (__capacity > __max_chunk_capacity) {
+                __capacity = __max_chunk_capacity;
+            }
+            if (__capacity < sizeof(__chunk) + __needed) {
+                __capacity = sizeof(__chunk) + __needed;
+            }
+
+            void* __mem = ::operator new(__capacity);
+            if (__next != nullptr) {
+                __free_chunk(__next);
+            }
+            __next = ::new (__mem) __chunk;
+            __next->__end_ = static_cast<char*>(__mem) + __capacity;
+        }
+        __spare_ = nullptr;
+
+        __next->__prev_ = __chunk_;
+        __next->__prev_top_ = __top_;
+        __chunk_ = __next;
+        __top_ = __next->__data();
+    }
+
+    void __release(__block* __b) noexcept {
+        --__live_;
+        if (__b != __last_block_) {
+            __b->__prev_ |= 1;
+            return;
+        }
+
+        // Pop this block and any blocks beneath it that were freed earlier.
+        do {
+            __top_ = reinterpret_cast<char*>(__b);
+            __last_block_ = __b->__previous();
+            if (__top_ == __chunk_->__data() && __chunk_->__prev_ != nullptr) {
+                __chunk* __empty = __chunk_;
+                __chunk_ = __empty->__prev_;
+                __top_ = __empty->__prev_top_;
+                if (__spare_ == nullptr) {
+                    __spare_ = __empty;
+                } else {
+                    __free_chunk(__empty);
+                }
+            }
+            __b = __last_block_;
+        } while (__b != nullptr && __b->__freed());
+
+        if (__live_ == 0) {
+            __destroy();
+        }
+    }
+
+    __chunk* __chunk_ = nullptr;
+    char* __top_ = nullptr;
+    __block* __last_block_ = nullptr;
+    __chunk* __spare_ = nullptr;
+    std::size_t __live_ = 0;
+};
+
+// Stateless allocator that places generator frames into the LIFO arena of
+// the generator currently being resumed on this thread.
+//
+// Use it as the allocator parameter of std::generator; arena inheritance
+// relies on the allocator being part of the generator's type.
+template <typename _T>
+class lifo_arena_allocator {
+    static_assert(alignof(_T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "lifo_arena_allocator does not support over-aligned types");
+
+public:
+    using value_type = _T;
+    using is_always_equal = std::true_type;
+
+    lifo_arena_allocator() noexcept = default;
+
+    template <typename _U>
+    lifo_arena_allocator(const lifo_arena_allocator<_U>&) noexcept {}
+
+    _T* allocate(std::size_t __n) {
+        return static_cast<_T*>(__lifo_arena::allocate(__n * sizeof(_T)));
+    }
+
+    void deallocate(_T* __p, std::size_t __n) noexcept {
+        __lifo_arena::deallocate(__p, __n * sizeof(_T));
+    }
+
+    template <typename _U>
+    friend bool operator==(const lifo_arena_allocator&, const lifo_arena_allocator<_U>&) noexcept {
+        return true;
+    }
+};
+
+} // namespace std::experimental
+
+namespace std {
+
+// Generators using lifo_arena_allocator remember the arena their frame was
+// placed in and make it current whenever the consumer resumes them.
+template <>
+class __promise_base_alloc<experimental::lifo_arena_allocator<std::byte>> {
+    using __arena = experimental::__lifo_arena;
+
+public:
+    static void* operator new(std::size_t __size) {
+        void* __frame = __arena::allocate(__size);
+        __generator_instrumentation::__on_allocate(__size);
+        __generator_frames::__on_allocate(__size);
+        return __frame;
+    }
+
+    static void operator delete(void* __ptr, std::size_t __size) noexcept {
+        __arena::deallocate(__ptr, __size);
+        __generator_instrumentation::__on_deallocate();
+    }
+
+    struct __resume_guard {
+        explicit __resume_guard(__promise_base_alloc& __promise) noexcept
+            : __prev_(std::exchange(__arena::__current_, __promise.__arena_)) {}
+
+        __resume_guard(const __resume_guard&) = delete;
+        __resume_guard& operator=(const __resume_guard&) = delete;
+
+        ~__resume_guard() {
+            __arena::__current_ = __prev_;
+        }
+
+        __arena* __prev_;
+    };
+
+private:
+    __arena* __arena_ = __arena::__arena_containing(this);
+};
+
+} // namespace std
+
+#endif // __STD_LIFO_ARENA_INCLUDED
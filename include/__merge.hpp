@@ -0,0 +1,174 @@
+#ifndef __STD_MERGE_INCLUDED
+#define __STD_MERGE_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// merge(): k-way merge of sorted generators.
+//
+// merge(g1, g2, ...) and merge(range_of_generators) yield the values of
+// all inputs, each sorted in ascending order, as one ascending sequence.
+// Equal values are yielded in the order of the inputs they come from.
+//
+// The merge holds an iterator into every input and reads their current
+// values in place, so inputs are not nested under the merge and a value of
+// reference type is passed on without a copy. The smallest value is found
+// with a loser tree: a compact array of input indices, one per internal
+// node of a tournament over the inputs, holding the loser of the match
+// played there. After the winning input advances, only the matches on its
+// path to the root are replayed, which takes ceil(log2(k)) comparisons and
+// touches one array element per level, where a binary heap needs up to
+// twice as many comparisons to sift a replaced element down.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace std::experimental {
+
+template <typename _T>
+inline constexpr bool __is_generator = false;
+
+template <typename _Ref, typename _Value, typename _Alloc>
+inline constexpr bool __is_generator<std::generator<_Ref, _Value, _Alloc>> = true;
+
+// Stands in for the key array when values are not cached.
+struct __no_keys {
+    explicit __no_keys(std::uint32_t) noexcept {}
+};
+
+template <typename _Ref, typename _Value, typename _Alloc>
+std::generator<_Ref, _Value>
+__merge(std::vector<std::generator<_Ref, _Value, _Alloc>> __gens) {
+    using __elem_t = std::remove_reference_t<_Ref>;
+    const std::uint32_t __k = static_cast<std::uint32_t>(__gens.size());
+    if (__k == 0) {
+        co_return;
+    }
+
+    // Small trivially copyable values are also copied into a compact array,
+    // so that replaying matches does not touch the inputs' frames. Other
+    // values get no array, so need not be default constructible.
+    using __key_t = std::remove_cv_t<__elem_t>;
+    constexpr bool __cache_keys =
+        std::is_trivially_copyable_v<__key_t> && sizeof(__key_t) <= 16 &&
+        std::is_default_constructible_v<__key_t>;
+
+    std::vector<typename std::generator<_Ref, _Value, _Alloc>::iterator> __its;
+    __its.reserve(__k);
+    // Current value of each input, or nullptr once it is exhausted.
+    std::vector<const __elem_t*> __heads(__k);
+    std::conditional_t<__cache_keys, std::vector<__key_t>, __no_keys> __keys(__k);
+    auto __load = [&](std::uint32_t __i) {
+        if (__its[__i] == __gens[__i].end()) {
+            __heads[__i] = nullptr;
+        } else {
+            __heads[__i] = std::addressof(__its[__i].__peek());
+            if constexpr (__cache_keys) {
+                __keys[__i] = *__heads[__i];
+            }
+        }
+    };
+    for (std::uint32_t __i = 0; __i != __k; ++__i) {
+        __its.push_back(__gens[__i].begin());
+        __load(__i);
+    }
+
+    // Whether input __a's value comes before input __b's. Exhausted inputs
+    // come last, and ties go to the lower index.
+    auto __before = [&](std::uint32_t __a, std::uint32_t __b) {
+        if (__heads[__a] == nullptr || __heads[__b] == nullptr) {
+            return __heads[__b] == nullptr && (__heads[__a] != nullptr || __a < __b);
+        }
+        auto __less = [&](const __elem_t& __x, const __elem_t& __y) {
+            if (__x < __y) {
+                return true;
+            }
+            return !(__y < __x) && __a < __b;
+        };
+        if constexpr (__cache_keys) {
+            return __less(__keys[__a], __keys[__b]);
+        } else {
+            return __less(*__heads[__a], *__heads[__b]);
+        }
+    };
+
+    // Input __i is the leaf at node __k + __i, and node __n's children are
+    // nodes 2 * __n and 2 * __n + 1. Node 0 is unused.
+    std::vector<std::uint32_t> __losers(__k);
+    std::uint32_t __winner = 0;
+    {
+        std::vector<std::uint32_t> __winners(2 * __k);
+        for (std::uint32_t __i = 0; __i != __k; ++__i) {
+            __winners[__k + __i] = __i;
+        }
+        for (std::uint32_t __n = __k - 1; __n >= 1; --__n) {
+            std::uint32_t __l = __winners[2 * __n];
+            std::uint32_t __r = __winners[2 * __n + 1];
+            if (!__before(__l, __r)) {
+                std::swap(__l, __r);
+            }
+            __winners[__n] = __l;
+            __losers[__n] = __r;
+        }
+        __winner = __k == 1 ? 0 : __winners[1];
+    }
+
+    while (__heads[__winner] != nullptr) {
+        if constexpr (std::is_reference_v<_Ref>) {
+            co_yield static_cast<_Ref>(*__its[__winner]);
+        } else {
+            co_yield __its[__winner].take();
+        }
+        ++__its[__winner];
+        __load(__winner);
+        for (std::uint32_t __n = (__k + __winner) / 2; __n >= 1; __n /= 2) {
+            if (__before(__losers[__n], __winner)) {
+                std::swap(__losers[__n], __winner);
+            }
+        }
+    }
+}
+
+// Merges sorted generators of the same type.
+template <typename _Ref, typename _Value, typename _Alloc, typename... _Gens>
+    requires (std::same_as<_Gens, std::generator<_Ref, _Value, _Alloc>> && ...)
+std::generator<_Ref, _Value>
+merge(std::generator<_Ref, _Value, _Alloc> __first, _Gens... __rest) {
+    std::vector<std::generator<_Ref, _Value, _Alloc>> __gens;
+    __gens.reserve(1 + sizeof...(_Gens));
+    __gens.push_back(std::move(__first));
+    (__gens.push_back(std::move(__rest)), ...);
+    return std::experimental::__merge(std::move(__gens));
+}
+
+// Merges the sorted generators in __gens, moving them out of the range.
+template <std::ranges::input_range _Rng>
+    requires __is_generator<std::ranges::range_value_t<_Rng>>
+auto merge(_Rng&& __gens) {
+    std::vector<std::ranges::range_value_t<_Rng>> __owned;
+    if constexpr (std::ranges::sized_range<_Rng>) {
+        __owned.reserve(std::ranges::size(__gens));
+    }
+    for (auto&& __g : __gens) {
+        __owned.push_back(std::move(__g));
+    }
+    return std::experimental::__merge(std::move(__owned));
+}
+
+} // namespace std::experimental
+
+#endif // __STD_MERGE_INCLUDED
@@ -0,0 +1,228 @@
+#ifndef __STD_MMAP_LINES_INCLUDED
+#define __STD_MMAP_LINES_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// mmap_lines(path): the lines of a file as string_views into a read-only
+// memory mapping of it.
+//
+// Lines are split on '\n', which is not part of the yielded views; as with
+// std::getline, a final line without a newline is yielded and a '\r'
+// before a newline is kept. No line is allocated or copied: each view
+// points into the mapping, which stays valid until the generator is
+// destroyed, so views may be kept for that long.
+//
+// The mapping is advised as sequential and, on POSIX systems, is prefetched
+// with MADV_WILLNEED one __readahead_window ahead of the line being
+// scanned. Newlines are found 64 bytes at a time with SSE2 where
+// available.
+//
+// On systems without mmap the file is read into memory instead. Failure to
+// open or map the file is reported as std::system_error when iteration
+// begins.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#define __STDGENERATOR_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace std::experimental {
+
+// Returns the first '\n' in [__first, __last), or __last if there is none.
+inline const char* __find_newline(const char* __first, const char* __last) noexcept {
+#if defined(__SSE2__)
+    const __m128i __newline = _mm_set1_epi8('\n');
+    auto __mask16 = [&](const char* __p) {
+        const __m128i __chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(__p));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(__chunk, __newline)));
+    };
+    while (__last - __first >= 64) {
+        const std::uint64_t __mask =
+            std::uint64_t(__mask16(__first)) |
+            std::uint64_t(__mask16(__first + 16)) << 16 |
+            std::uint64_t(__mask16(__first + 32)) << 32 |
+            std::uint64_t(__mask16(__first + 48)) << 48;
+        if (__mask != 0) {
+            return __first + std::countr_zero(__mask);
+        }
+        __first += 64;
+    }
+    while (__last - __first >= 16) {
+        if (const std::uint32_t __mask = __mask16(__first); __mask != 0) {
+            return __first + std::countr_zero(__mask);
+        }
+        __first += 16;
+    }
+#endif
+    const void* __found = std::memchr(__first, '\n', static_cast<std::size_t>(__last - __first));
+    return __found != nullptr ? static_cast<const char*>(__found) : __last;
+}
+
+[[noreturn]] inline void __throw_mmap_lines_error(const std::filesystem::path& __path) {
+    throw std::system_error(errno, std::generic_category(),
+                            "mmap_lines: cannot map '" + __path.string() + "'");
+}
+
+// Read-only view of the contents of a file, which is opened by __map().
+class __mapped_file {
+public:
+    static constexpr std::size_t __readahead_window = std::size_t(8) << 20;
+
+    explicit __mapped_file(std::filesystem::path __path) noexcept
+        : __path_(std::move(__path)) {}
+
+    __mapped_file(__mapped_file&& __other) noexcept
+        : __path_(std::move(__other.__path_))
+        , __data_(std::exchange(__other.__data_, nullptr))
+        , __size_(std::exchange(__other.__size_, 0))
+#if !defined(__STDGENERATOR_HAS_MMAP)
+        , __contents_(std::move(__other.__contents_))
+#endif
+    {}
+
+    __mapped_file& operator=(__mapped_file&&) = delete;
+
+#if defined(__STDGENERATOR_HAS_MMAP)
+    ~__mapped_file() {
+        if (__size_ != 0) {
+            ::munmap(const_cast<char*>(__data_), __size_);
+        }
+    }
+
+    void __map() {
+        const int __fd = ::open(__path_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (__fd < 0) {
+            __throw_mmap_lines_error(__path_);
+        }
+        struct ::stat __st;
+        if (::fstat(__fd, &__st) != 0) {
+            const int __error = errno;
+            ::close(__fd);
+            errno = __error;
+            __throw_mmap_lines_error(__path_);
+        }
+        const std::size_t __size = static_cast<std::size_t>(__st.st_size);
+        if (__size != 0) {
+#if defined(POSIX_FADV_SEQUENTIAL)
+            ::posix_fadvise(__fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            void* __p = ::mmap(nullptr, __size, PROT_READ, MAP_PRIVATE, __fd, 0);
+            if (__p == MAP_FAILED) {
+                const int __error = errno;
+                ::close(__fd);
+                errno = __error;
+                __throw_mmap_lines_error(__path_);
+            }
+            __data_ = static_cast<const char*>(__p);
+            __size_ = __size;
+            ::madvise(__p, __size_, MADV_SEQUENTIAL);
+            __will_need(0);
+            __will_need(__readahead_window);
+        }
+        // The mapping keeps the file contents accessible.
+        ::close(__fd);
+    }
+
+    // Asks for the __readahead_window bytes from __offset to be read ahead
+    // of use.
+    void __will_need(std::size_t __offset) const noexcept {
+        if (__offset >= __size_) {
+            return;
+        }
+        // madvise() needs a page-aligned start.
+        static const std::size_t __page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t __start = __offset & ~(__page - 1);
+        const std::size_t __length = std::min(__readahead_window, __size_ - __start);
+        ::madvise(const_cast<char*>(__data_) + __start, __length, MADV_WILLNEED);
+    }
+#else
+    void __map() {
+        std::ifstream __in(__path_, std::ios::binary);
+        if (!__in) {
+            errno = ENOENT;
+            __throw_mmap_lines_error(__path_);
+        }
+        __contents_.assign(std::istreambuf_iterator<char>(__in), std::istreambuf_iterator<char>());
+        __data_ = __contents_.data();
+        __size_ = __contents_.size();
+    }
+
+    void __will_need(std::size_t) const noexcept {}
+#endif
+
+    const char* __data() const noexcept {
+        return __data_;
+    }
+
+    std::size_t __size() const noexcept {
+        return __size_;
+    }
+
+private:
+    std::filesystem::path __path_;
+    const char* __data_ = nullptr;
+    std::size_t __size_ = 0;
+#if !defined(__STDGENERATOR_HAS_MMAP)
+    std::string __contents_;
+#endif
+};
+
+// __file is a parameter rather than a local so that the mapping lives until
+// the generator is destroyed, not just until the last line is yielded.
+inline std::generator<std::string_view> __mmap_lines(__mapped_file __file) {
+    __file.__map();
+    const char* const __begin = __file.__data();
+    const char* const __end = __begin + __file.__size();
+    std::size_t __next_window = __mapped_file::__readahead_window;
+    for (const char* __p = __begin; __p != __end;) {
+        if (static_cast<std::size_t>(__p - __begin) >= __next_window) {
+            // Stay one window ahead of the scan.
+            __file.__will_need(__next_window + __mapped_file::__readahead_window);
+            __next_window += __mapped_file::__readahead_window;
+        }
+        const char* __newline = __find_newline(__p, __end);
+        co_yield std::string_view(__p, static_cast<std::size_t>(__newline - __p));
+        if (__newline == __end) {
+            break;
+        }
+        __p = __newline + 1;
+    }
+}
+
+inline std::generator<std::string_view> mmap_lines(std::filesystem::path __path) {
+    return std::experimental::__mmap_lines(__mapped_file(std::move(__path)));
+}
+
+} // namespace std::experimental
+
+#endif // __STD_MMAP_LINES_INCLUDED
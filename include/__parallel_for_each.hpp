@@ -0,0 +1,215 @@
+#ifndef __STD_PARALLEL_FOR_EACH_INCLUDED
+#define __STD_PARALLEL_FOR_EACH_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// parallel_for_each(gen, pool, fn): applies fn to every value of a
+// generator on a thread_pool.
+//
+// The calling thread iterates the generator and copies or moves its values
+// into batches that are submitted to the pool as single tasks, so the
+// per-value cost of handing work to another thread is amortised over a
+// batch. Batches start with a single value and double in size while the
+// pool has enough work queued to keep every worker busy, so short or slow
+// generators still spread over all workers and long ones run with little
+// overhead.
+//
+// The number of batches in flight is bounded. When the bound is reached,
+// and once the generator is exhausted, the calling thread runs queued
+// batches itself instead of blocking.
+//
+// fn is shared by all threads and may be called concurrently. If fn
+// throws, no further batches are started and the first exception is
+// rethrown once all started batches have finished. Exceptions from the
+// generator are rethrown the same way.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+#include <__thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace std::experimental {
+
+template <typename _Value, typename _Fn>
+class __parallel_for_each_state {
+public:
+    static constexpr std::size_t __max_batch_size = 4096;
+
+    __parallel_for_each_state(thread_pool& __pool, _Fn& __fn)
+        : __pool_(__pool)
+        , __fn_(__fn)
+        , __max_in_flight_(4 * (__pool.size() + 1))
+    {}
+
+    struct __batch : __pool_task {
+        __parallel_for_each_state* __state_;
+        std::vector<_Value> __values_;
+
+        explicit __batch(__parallel_for_each_state* __state)
+            : __pool_task{&__batch::__execute}
+            , __state_(__state) {}
+
+        static void __execute(__pool_task* __t) noexcept {
+            __batch* __self = static_cast<__batch*>(__t);
+            __self->__state_->__run(__self);
+        }
+    };
+
+    // Returns an empty batch with room for the next batch size.
+    std::unique_ptr<__batch> __new_batch() {
+        std::unique_ptr<__batch> __b;
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            if (!__free_.empty()) {
+                __b = std::move(__free_.back());
+                __free_.pop_back();
+            }
+        }
+        if (!__b) {
+            __b = std::make_unique<__batch>(this);
+        }
+        __b->__values_.reserve(__batch_size_);
+        return __b;
+    }
+
+    void __submit(std::unique_ptr<__batch> __b) {
+        // Grow batches while there is a backlog for every worker. A producer
+        // that is slower than the workers never builds one, so its values
+        // keep being spread out one by one.
+        if (__pool_.__queued() >= __pool_.size()) {
+            __batch_size_ = std::min(__batch_size_ * 2, __max_batch_size);
+        }
+
+        __in_flight_.fetch_add(1, std::memory_order_relaxed);
+        __pool_.__submit(__b.release());
+        __wait_until_in_flight_below(__max_in_flight_);
+    }
+
+    std::size_t __batch_size() const noexcept {
+        return __batch_size_;
+    }
+
+    bool __failed() const noexcept {
+        return __failed_.load(std::memory_order_relaxed);
+    }
+
+    void __fail(std::exception_ptr __e) noexcept {
+        std::lock_guard<std::mutex> __lock(__mutex_);
+        if (!__exception_) {
+            __exception_ = std::move(__e);
+            __failed_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Waits for all submitted batches, then rethrows the first failure.
+    void __finish() {
+        __wait_until_in_flight_below(1);
+        // Synchronise with the worker that completed the last batch.
+        std::lock_guard<std::mutex> __lock(__mutex_);
+        if (__exception_) {
+            std::rethrow_exception(__exception_);
+        }
+    }
+
+private:
+    void __run(__batch* __b) noexcept {
+        if (!__failed()) {
+            try {
+                for (_Value& __value : __b->__values_) {
+                    std::invoke(__fn_, __value);
+                }
+            } catch (...) {
+                __fail(std::current_exception());
+            }
+        }
+        __b->__values_.clear();
+
+        // The state may be destroyed as soon as the lock is released after
+        // the last batch completes.
+        std::lock_guard<std::mutex> __lock(__mutex_);
+        __free_.emplace_back(__b);
+        __in_flight_.fetch_sub(1, std::memory_order_release);
+        if (__waiting_) {
+            __done_.notify_one();
+        }
+    }
+
+    // Runs queued batches on the calling thread while there are any, and
+    // sleeps while all remaining batches are running on workers.
+    void __wait_until_in_flight_below(std::size_t __limit) {
+        while (__in_flight_.load(std::memory_order_acquire) >= __limit) {
+            if (__pool_.__run_pending_task()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> __lock(__mutex_);
+            __waiting_ = true;
+            while (__in_flight_.load(std::memory_order_relaxed) >= __limit) {
+                __done_.wait(__lock);
+            }
+            __waiting_ = false;
+        }
+    }
+
+    thread_pool& __pool_;
+    _Fn& __fn_;
+    const std::size_t __max_in_flight_;
+    // Only used by the thread iterating the generator.
+    std::size_t __batch_size_ = 1;
+
+    std::atomic<std::size_t> __in_flight_{0};
+    std::atomic<bool> __failed_{false};
+
+    std::mutex __mutex_;
+    std::condition_variable __done_;
+    bool __waiting_ = false;
+    std::vector<std::unique_ptr<__batch>> __free_;
+    std::exception_ptr __exception_;
+};
+
+// Invokes __fn with an lvalue of each value of __gen, on the threads of
+// __pool and the calling thread, in no particular order.
+template <typename _Ref, typename _Value, typename _Alloc, typename _Fn>
+void parallel_for_each(std::generator<_Ref, _Value, _Alloc>&& __gen, thread_pool& __pool, _Fn __fn) {
+    using __state_t = __parallel_for_each_state<_Value, _Fn>;
+    __state_t __state(__pool, __fn);
+
+    try {
+        auto __b = __state.__new_batch();
+        for (auto&& __value : __gen) {
+            __b->__values_.push_back(static_cast<decltype(__value)>(__value));
+            if (__b->__values_.size() >= __state.__batch_size()) {
+                __state.__submit(std::move(__b));
+                if (__state.__failed()) {
+                    break;
+                }
+                __b = __state.__new_batch();
+            }
+        }
+        if (__b && !__b->__values_.empty() && !__state.__failed()) {
+            __state.__submit(std::move(__b));
+        }
+    } catch (...) {
+        __state.__fail(std::current_exception());
+    }
+    __state.__finish();
+}
+
+} // namespace std::experimental
+
+#endif // __STD_PARALLEL_FOR_EACH_INCLUDED
@@ -0,0 +1,232 @@
+#ifndef __STD_PREFETCH_INCLUDED
+#define __STD_PREFETCH_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// prefetch(gen, capacity): runs the producer of a generator on a worker
+// thread.
+//
+// The returned generator starts a worker thread when it is first iterated.
+// The worker iterates the source generator and hands values to the
+// consumer through a bounded single-producer/single-consumer ring of
+// 'capacity' values, so producing the next values overlaps with consuming
+// the current ones. The producer only blocks when the ring is full and the
+// consumer only blocks when it is empty.
+//
+// The source generator is moved onto the worker thread and destroyed
+// there once it completes. An exception escaping the source is rethrown to
+// the consumer after the values produced before it. Destroying the
+// returned generator early stops the worker after its current value and
+// joins it.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace std::experimental {
+
+// Bounded ring buffer with one producer thread and one consumer thread.
+//
+// Both indices count values ever pushed/popped and are published shifted
+// left by one. The low bit of __tail_ marks that the producer has closed
+// the ring; the low bit of __head_ marks that the consumer has stopped
+// reading. Each side waits on the other side's index, so closing or
+// stopping also wakes the other side.
+//
+// A side about to block first raises its waiting flag, and the other side
+// only notifies when it finds the flag raised, clearing it. Notifying is a
+// system call even without waiters, so this keeps hand-over free of them
+// while both sides are busy.
+template <typename _Value>
+class __spsc_ring {
+public:
+    explicit __spsc_ring(std::size_t __capacity)
+        : __capacity_(std::bit_ceil(__capacity == 0 ? std::size_t(1) : __capacity))
+        , __slots_(new __manual_lifetime<_Value>[__capacity_])
+    {}
+
+    __spsc_ring(const __spsc_ring&) = delete;
+    __spsc_ring& operator=(const __spsc_ring&) = delete;
+
+    ~__spsc_ring() {
+        const std::size_t __tail = __tail_.load(std::memory_order_acquire) >> 1;
+        for (std::size_t __i = __head_local_; __i != __tail; ++__i) {
+            __slot(__i).destruct();
+        }
+    }
+
+    // Producer side. Returns false once the consumer has stopped.
+    template <typename _U>
+    bool __push(_U&& __value) {
+        const std::size_t __tail = __tail_local_;
+        if (__tail - __head_cache_ == __capacity_) {
+            for (;;) {
+                const std::size_t __head = __head_.load(std::memory_order_acquire);
+                if (__head & 1) {
+                    return false;
+                }
+                __head_cache_ = __head >> 1;
+                if (__tail - __head_cache_ != __capacity_) {
+                    break;
+                }
+                __wait(__head_, __head, __producer_waiting_);
+            }
+        }
+
+        __slot(__tail).construct((_U&&)__value);
+        __tail_local_ = __tail + 1;
+        __tail_.store(__tail_local_ << 1, std::memory_order_seq_cst);
+        __notify(__tail_, __consumer_waiting_);
+        return true;
+    }
+
+    // Producer side. __exception, if any, is rethrown to the consumer once
+    // it has read all values pushed before.
+    void __close(std::exception_ptr __exception) noexcept {
+        __exception_ = std::move(__exception);
+        __tail_.store((__tail_local_ << 1) | 1, std::memory_order_seq_cst);
+        __tail_.notify_one();
+    }
+
+    // Consumer side. Blocks until a value is available and returns it, or
+    // returns nullptr once the ring is closed and drained.
+    _Value* __front() {
+        const std::size_t __head = __head_local_;
+        if (__head == __tail_cache_) {
+            for (;;) {
+                const std::size_t __tail = __tail_.load(std::memory_order_acquire);
+                __tail_cache_ = __tail >> 1;
+                if (__head != __tail_cache_) {
+                    break;
+                }
+                if (__tail & 1) {
+                    if (__exception_) {
+                        std::rethrow_exception(std::exchange(__exception_, nullptr));
+                    }
+                    return nullptr;
+                }
+                __wait(__tail_, __tail, __consumer_waiting_);
+            }
+        }
+        return std::addressof(__slot(__head).get());
+    }
+
+    // Consumer side. Destroys the value returned by __front().
+    void __pop() noexcept {
+        __slot(__head_local_).destruct();
+        ++__head_local_;
+        __head_.store(__head_local_ << 1, std::memory_order_seq_cst);
+        __notify(__head_, __producer_waiting_);
+    }
+
+    // Consumer side. Tells the producer to stop pushing.
+    void __stop() noexcept {
+        __head_.fetch_or(1, std::memory_order_seq_cst);
+        __head_.notify_one();
+    }
+
+private:
+    static void __wait(std::atomic<std::size_t>& __index, std::size_t __old,
+                       std::atomic<bool>& __waiting) noexcept {
+        __waiting.store(true, std::memory_order_seq_cst);
+        if (__index.load(std::memory_order_seq_cst) == __old) {
+            __index.wait(__old, std::memory_order_acquire);
+        }
+    }
+
+    static void __notify(std::atomic<std::size_t>& __index,
+                         std::atomic<bool>& __waiting) noexcept {
+        if (__waiting.load(std::memory_order_seq_cst) &&
+            __waiting.exchange(false, std::memory_order_seq_cst)) {
+            __index.notify_one();
+        }
+    }
+
+    __manual_lifetime<_Value>& __slot(std::size_t __index) noexcept {
+        return __slots_[__index & (__capacity_ - 1)];
+    }
+
+    static constexpr std::size_t __cache_line = 64;
+
+    const std::size_t __capacity_;
+    const std::unique_ptr<__manual_lifetime<_Value>[]> __slots_;
+    std::exception_ptr __exception_;
+
+    // Written by the consumer.
+    alignas(__cache_line) std::atomic<std::size_t> __head_{0};
+    std::atomic<bool> __consumer_waiting_{false};
+    // Owned by the consumer.
+    alignas(__cache_line) std::size_t __head_local_ = 0;
+    std::size_t __tail_cache_ = 0;
+
+    // Written by the producer.
+    alignas(__cache_line) std::atomic<std::size_t> __tail_{0};
+    std::atomic<bool> __producer_waiting_{false};
+    // Owned by the producer.
+    alignas(__cache_line) std::size_t __tail_local_ = 0;
+    std::size_t __head_cache_ = 0;
+};
+
+template <typename _Ref, typename _Value, typename _Alloc>
+void __prefetch_produce(std::generator<_Ref, _Value, _Alloc> __source,
+                        __spsc_ring<_Value>& __ring) noexcept {
+    std::exception_ptr __exception;
+    try {
+        for (auto&& __value : __source) {
+            if (!__ring.__push(static_cast<decltype(__value)>(__value))) {
+                break;
+            }
+        }
+    } catch (...) {
+        __exception = std::current_exception();
+    }
+    // Release the source's frames on this thread before handing over.
+    __source = {};
+    __ring.__close(std::move(__exception));
+}
+
+// Returns a generator yielding the values of __source, produced on a
+// worker thread up to __capacity values ahead of the consumer.
+template <typename _Ref, typename _Value, typename _Alloc>
+std::generator<_Value&&, _Value>
+prefetch(std::generator<_Ref, _Value, _Alloc> __source, std::size_t __capacity = 64) {
+    __spsc_ring<_Value> __ring(__capacity);
+
+    std::thread __worker(&__prefetch_produce<_Ref, _Value, _Alloc>,
+                         std::move(__source), std::ref(__ring));
+
+    // Stops and joins the worker however this coroutine finishes,
+    // including destruction of the generator while it is suspended.
+    struct __joiner {
+        __spsc_ring<_Value>& __ring_;
+        std::thread& __worker_;
+
+        ~__joiner() {
+            __ring_.__stop();
+            __worker_.join();
+        }
+    } __join{__ring, __worker};
+
+    while (_Value* __value = __ring.__front()) {
+        co_yield std::move(*__value);
+        __ring.__pop();
+    }
+}
+
+} // namespace std::experimental
+
+#endif // __STD_PREFETCH_INCLUDED
@@ -0,0 +1,202 @@
+#ifndef __STD_READ_CHUNKS_INCLUDED
+#define __STD_READ_CHUNKS_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// read_chunks(fd, chunk_size): the contents of a file descriptor as spans
+// of chunk_size bytes, read ahead on a helper thread.
+//
+// Two buffers of chunk_size bytes are allocated when iteration begins and
+// then recycled: while the consumer works on one, a helper thread fills
+// the other, so reading overlaps with processing and no memory is
+// allocated per chunk. A span is valid until the iterator is incremented.
+// Every chunk but the last holds exactly chunk_size bytes.
+//
+// Seekable files are read with pread() from the descriptor's offset when
+// iteration begins, which is left unchanged. Pipes, sockets and other
+// descriptors that cannot be read at an offset are read with read(). The
+// descriptor is not closed.
+//
+// A read error is reported as std::system_error from the increment that
+// would have returned the failed chunk. Destroying the generator waits for
+// a read in progress to finish, which on a pipe means until data arrives
+// or the writer closes it.
+//
+// Only available on POSIX systems.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#if __has_include(<unistd.h>)
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <thread>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace std::experimental {
+
+// Reads a file descriptor into two buffers in turn on a helper thread.
+class __chunk_reader {
+public:
+    __chunk_reader(int __fd, std::size_t __chunk_size)
+        : __fd_(__fd)
+        , __chunk_size_(__chunk_size)
+    {
+        for (__slot& __s : __slots_) {
+            __s.__data_.reset(new std::byte[__chunk_size]);
+        }
+        __offset_ = ::lseek(__fd, 0, SEEK_CUR);
+        __thread_ = std::thread([this] { __run(); });
+    }
+
+    __chunk_reader(const __chunk_reader&) = delete;
+    __chunk_reader& operator=(const __chunk_reader&) = delete;
+
+    ~__chunk_reader() {
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __stopping_ = true;
+        }
+        __changed_.notify_all();
+        __thread_.join();
+    }
+
+    // Waits for chunk __index to be read. Returns an empty span after the
+    // last chunk.
+    std::span<const std::byte> __wait(std::size_t __index) {
+        __slot& __s = __slots_[__index % 2];
+        std::unique_lock<std::mutex> __lock(__mutex_);
+        __changed_.wait(__lock, [&] { return __s.__full_; });
+        if (__s.__error_ != 0) {
+            throw std::system_error(__s.__error_, std::generic_category(),
+                                    "read_chunks: read failed");
+        }
+        return {__s.__data_.get(), __s.__size_};
+    }
+
+    // Hands the buffer of chunk __index back to the helper thread.
+    void __release(std::size_t __index) {
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __slots_[__index % 2].__full_ = false;
+        }
+        __changed_.notify_all();
+    }
+
+private:
+    struct __slot {
+        std::unique_ptr<std::byte[]> __data_;
+        std::size_t __size_ = 0;
+        int __error_ = 0;
+        // Set by the helper thread once the chunk has been read; cleared
+        // by the consumer once it is done with it. Guarded by __mutex_.
+        bool __full_ = false;
+    };
+
+    void __run() {
+        for (std::size_t __index = 0;; ++__index) {
+            __slot& __s = __slots_[__index % 2];
+            {
+                std::unique_lock<std::mutex> __lock(__mutex_);
+                __changed_.wait(__lock, [&] { return !__s.__full_ || __stopping_; });
+                if (__stopping_) {
+                    return;
+                }
+            }
+            std::size_t __size = 0;
+            int __error = 0;
+            while (__size != __chunk_size_) {
+                const ::ssize_t __n = __read(__s.__data_.get() + __size, __chunk_size_ - __size);
+                if (__n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    __error = errno;
+                    break;
+                }
+                if (__n == 0) {
+                    break;
+                }
+                __size += static_cast<std::size_t>(__n);
+            }
+            {
+                std::lock_guard<std::mutex> __lock(__mutex_);
+                __s.__size_ = __size;
+                __s.__error_ = __error;
+                __s.__full_ = true;
+            }
+            __changed_.notify_all();
+            if (__size != __chunk_size_) {
+                // End of input or an error. If the last chunk was not empty,
+                // the next slot is marked as an empty chunk to end the
+                // sequence.
+                if (__size != 0 && __error == 0) {
+                    __slot& __next = __slots_[(__index + 1) % 2];
+                    std::unique_lock<std::mutex> __lock(__mutex_);
+                    __changed_.wait(__lock, [&] { return !__next.__full_ || __stopping_; });
+                    __next.__size_ = 0;
+                    __next.__full_ = true;
+                    __changed_.notify_all();
+                }
+                return;
+            }
+        }
+    }
+
+    ::ssize_t __read(std::byte* __buffer, std::size_t __size) {
+        if (__offset_ >= 0) {
+            const ::ssize_t __n = ::pread(__fd_, __buffer, __size, __offset_);
+            if (__n >= 0) {
+                __offset_ += __n;
+                return __n;
+            }
+            if (errno != ESPIPE) {
+                return __n;
+            }
+            __offset_ = -1;
+        }
+        return ::read(__fd_, __buffer, __size);
+    }
+
+    const int __fd_;
+    const std::size_t __chunk_size_;
+    // Offset of the next pread(), or -1 if the descriptor is not seekable.
+    ::off_t __offset_;
+    __slot __slots_[2];
+    std::mutex __mutex_;
+    std::condition_variable __changed_;
+    bool __stopping_ = false;
+    std::thread __thread_;
+};
+
+inline std::generator<std::span<const std::byte>> read_chunks(int __fd, std::size_t __chunk_size) {
+    __chunk_reader __reader(__fd, __chunk_size == 0 ? 1 : __chunk_size);
+    for (std::size_t __index = 0;; ++__index) {
+        const std::span<const std::byte> __chunk = __reader.__wait(__index);
+        if (__chunk.empty()) {
+            break;
+        }
+        co_yield __chunk;
+        __reader.__release(__index);
+    }
+}
+
+} // namespace std::experimental
+
+#endif // __has_include(<unistd.h>)
+
+#endif // __STD_READ_CHUNKS_INCLUDED
@@ -0,0 +1,125 @@
+#ifndef __STD_SET_OPERATIONS_INCLUDED
+#define __STD_SET_OPERATIONS_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// Intersection and union of sorted generators.
+//
+// Both take generators whose values are sorted in ascending order and
+// free of duplicates, and yield the result in the same order. They move
+// through their inputs with iterator::skip_to(), so an input that yields
+// via std::ranges::seekable, such as sorted_elements(), jumps straight
+// past values that cannot contribute instead of producing each one. The
+// results are seekable themselves and pass a consumer's skip_to() on to
+// their inputs, so nested intersections and unions stay sublinear.
+//
+// sorted_elements() yields the elements of a sorted random-access range
+// and serves skip_to() with gallop_lower_bound(): an exponential probe
+// from the current position followed by a binary search, which costs
+// O(log d) comparisons to skip d elements.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <__generator.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+
+namespace std::experimental {
+
+// Returns the first position in the sorted range [__first, __last) whose
+// element is not less than __key, probing 1, 2, 4, ... elements ahead of
+// __first before binary searching the last gap.
+template <std::random_access_iterator _It, typename _T>
+_It gallop_lower_bound(_It __first, _It __last, const _T& __key) {
+    if (__first == __last || !(*__first < __key)) {
+        return __first;
+    }
+    const std::iter_difference_t<_It> __size = __last - __first;
+    std::iter_difference_t<_It> __bound = 1;
+    while (__bound < __size && __first[__bound] < __key) {
+        __bound *= 2;
+    }
+    // __first[__bound / 2] < __key, and __first[__bound] is not, if present.
+    return std::lower_bound(__first + (__bound / 2 + 1),
+                            __first + std::min(__bound, __size), __key);
+}
+
+// Yields the elements of a sorted range, which must outlive the generator.
+template <std::ranges::random_access_range _Rng>
+    requires std::ranges::sized_range<_Rng>
+std::generator<const std::ranges::range_value_t<_Rng>&, std::ranges::range_value_t<_Rng>>
+sorted_elements(const _Rng& __rng) {
+    auto __it = std::ranges::begin(__rng);
+    const auto __end = __it + std::ranges::distance(__rng);
+    while (__it != __end) {
+        if (const auto* __key = co_yield std::ranges::seekable(*__it)) {
+            __it = gallop_lower_bound(__it, __end, *__key);
+        } else {
+            ++__it;
+        }
+    }
+}
+
+// Yields the values present in both __a and __b.
+template <typename _Value, typename _Ref1, typename _Alloc1, typename _Ref2, typename _Alloc2>
+std::generator<_Value> set_intersection(std::generator<_Ref1, _Value, _Alloc1> __a,
+                                        std::generator<_Ref2, _Value, _Alloc2> __b) {
+    auto __ia = __a.begin();
+    auto __ib = __b.begin();
+    while (__ia != __a.end() && __ib != __b.end()) {
+        _Value __x = *__ia;
+        _Value __y = *__ib;
+        if (__x < __y) {
+            __ia.skip_to(__y);
+        } else if (__y < __x) {
+            __ib.skip_to(__x);
+        } else if (const _Value* __key = co_yield std::ranges::seekable(__x)) {
+            __ia.skip_to(*__key);
+            __ib.skip_to(*__key);
+        } else {
+            ++__ia;
+            ++__ib;
+        }
+    }
+}
+
+// Yields the values present in either __a or __b, once each.
+template <typename _Value, typename _Ref1, typename _Alloc1, typename _Ref2, typename _Alloc2>
+std::generator<_Value> set_union(std::generator<_Ref1, _Value, _Alloc1> __a,
+                                 std::generator<_Ref2, _Value, _Alloc2> __b) {
+    auto __ia = __a.begin();
+    auto __ib = __b.begin();
+    while (true) {
+        const bool __a_done = __ia == __a.end();
+        const bool __b_done = __ib == __b.end();
+        if (__a_done && __b_done) {
+            break;
+        }
+        // On a tie the value is taken from __a and both inputs advance.
+        const bool __from_a = !__a_done && (__b_done || !(*__ib < *__ia));
+        const bool __from_b = !__b_done && (__a_done || !(*__ia < *__ib));
+        _Value __x = __from_a ? __ia.take() : __ib.take();
+        if (__from_a) {
+            ++__ia;
+        }
+        if (__from_b) {
+            ++__ib;
+        }
+        if (const _Value* __key = co_yield std::ranges::seekable(__x)) {
+            // Both inputs are already past __x, which is less than *__key.
+            __ia.skip_to(*__key);
+            __ib.skip_to(*__key);
+        }
+    }
+}
+
+} // namespace std::experimental
+
+#endif // __STD_SET_OPERATIONS_INCLUDED
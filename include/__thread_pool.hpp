@@ -0,0 +1,200 @@
+#ifndef __STD_THREAD_POOL_INCLUDED
+#define __STD_THREAD_POOL_INCLUDED
+///////////////////////////////////////////////////////////////////////////////
+// Work-stealing thread pool.
+//
+// Each worker owns a deque of tasks. A worker pushes and pops tasks at the
+// back of its own deque, and steals from the front of the other deques
+// when its own is empty. Tasks submitted from outside the pool are spread
+// over the deques round-robin. Idle workers sleep until a task is
+// submitted.
+//
+// Tasks are intrusive (__pool_task) so that submitting one does not
+// allocate; submit() wraps an arbitrary callable for convenience.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace std::experimental {
+
+// Unit of work run by a thread_pool. __execute_ is responsible for
+// releasing the task.
+struct __pool_task {
+    void (*__execute_)(__pool_task*) noexcept;
+};
+
+class thread_pool {
+public:
+    explicit thread_pool(std::size_t __threads = std::thread::hardware_concurrency())
+        : __queues_(__threads == 0 ? 1 : __threads) {
+        __workers_.reserve(__queues_.size());
+        for (std::size_t __i = 0; __i != __queues_.size(); ++__i) {
+            __workers_.emplace_back([this, __i] { __run(__i); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Runs all tasks submitted so far, then joins the workers.
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> __lock(__sleep_mutex_);
+            __stopping_ = true;
+        }
+        __wake_.notify_all();
+        for (std::thread& __t : __workers_) {
+            __t.join();
+        }
+    }
+
+    std::size_t size() const noexcept {
+        return __workers_.size();
+    }
+
+    // Runs __f() on one of the workers. __f must not throw.
+    template <typename _F>
+    void submit(_F&& __f) {
+        struct __task : __pool_task {
+            std::decay_t<_F> __f_;
+
+            explicit __task(_F&& __f)
+                : __pool_task{&__task::__execute}
+                , __f_((_F&&)__f) {}
+
+            static void __execute(__pool_task* __t) noexcept {
+                std::unique_ptr<__task> __self(static_cast<__task*>(__t));
+                __self->__f_();
+            }
+        };
+        __submit(new __task((_F&&)__f));
+    }
+
+    void __submit(__pool_task* __task) {
+        std::size_t __index;
+        if (__current_pool_ == this) {
+            __index = __current_index_;
+        } else {
+            __index = __next_queue_.fetch_add(1, std::memory_order_relaxed) % __queues_.size();
+        }
+        {
+            __queue& __q = __queues_[__index];
+            std::lock_guard<std::mutex> __lock(__q.__mutex_);
+            __q.__tasks_.push_back(__task);
+            // Counted under the lock, before the task can be taken, so that
+            // a taker's decrement never precedes it.
+            __queued_.fetch_add(1, std::memory_order_seq_cst);
+        }
+        if (__sleepers_.load(std::memory_order_seq_cst) != 0) {
+            std::lock_guard<std::mutex> __lock(__sleep_mutex_);
+            __wake_.notify_one();
+        }
+    }
+
+    // Number of tasks waiting to be picked up by a worker.
+    std::size_t __queued() const noexcept {
+        return __queued_.load(std::memory_order_relaxed);
+    }
+
+    // Runs one queued task on the calling thread, if there is one. Lets a
+    // thread that is waiting for tasks to complete help with them.
+    bool __run_pending_task() {
+        std::size_t __start = __current_pool_ == this ? __current_index_ : 0;
+        if (__pool_task* __task = __take(__start)) {
+            __task->__execute_(__task);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct alignas(64) __queue {
+        std::mutex __mutex_;
+        std::deque<__pool_task*> __tasks_;
+    };
+
+    // Pops from the back of queue __index, else steals from the front of
+    // the others.
+    __pool_task* __take(std::size_t __index) {
+        if (__queued_.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        {
+            __queue& __own = __queues_[__index];
+            std::lock_guard<std::mutex> __lock(__own.__mutex_);
+            if (!__own.__tasks_.empty()) {
+                __pool_task* __task = __own.__tasks_.back();
+                __own.__tasks_.pop_back();
+                __queued_.fetch_sub(1, std::memory_order_relaxed);
+                return __task;
+            }
+        }
+        for (std::size_t __i = 1; __i != __queues_.size(); ++__i) {
+            __queue& __victim = __queues_[(__index + __i) % __queues_.size()];
+            std::unique_lock<std::mutex> __lock(__victim.__mutex_, std::try_to_lock);
+            if (__lock.owns_lock() && !__victim.__tasks_.empty()) {
+                __pool_task* __task = __victim.__tasks_.front();
+                __victim.__tasks_.pop_front();
+                __queued_.fetch_sub(1, std::memory_order_relaxed);
+                return __task;
+            }
+        }
+        return nullptr;
+    }
+
+    void __run(std::size_t __index) {
+        __current_pool_ = this;
+        __current_index_ = __index;
+        for (;;) {
+            if (__pool_task* __task = __take(__index)) {
+                __task->__execute_(__task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> __lock(__sleep_mutex_);
+            __sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            while (__queued_.load(std::memory_order_seq_cst) == 0 && !__stopping_) {
+                __wake_.wait(__lock);
+            }
+            __sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if (__stopping_ && __queued_.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+        }
+    }
+
+    static inline thread_local thread_pool* __current_pool_ = nullptr;
+    static inline thread_local std::size_t __current_index_ = 0;
+
+    std::vector<__queue> __queues_;
+    std::vector<std::thread> __workers_;
+    std::atomic<std::size_t> __next_queue_{0};
+    // Number of tasks in all queues.
+    std::atomic<std::size_t> __queued_{0};
+
+    std::mutex __sleep_mutex_;
+    std::condition_variable __wake_;
+    std::atomic<std::size_t> __sleepers_{0};
+    bool __stopping_ = false;
+};
+
+} // namespace std::experimental
+
+#endif // __STD_THREAD_POOL_INCLUDED
@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+// Module interface unit of the stdgenerator module, which exports
+// std::generator, std::pmr::generator, std::ranges::elements_of,
+// std::use_allocator_arg, std::ranges::size_hint and std::ranges::seekable,
+// together with the std::coroutine_traits and std::allocator_arg needed to
+// write generator coroutines.
+//
+// Build with -DSTDGENERATOR_BUILD_MODULE=ON and link the stdgenerator_module
+// target to write 'import stdgenerator;' instead of '#include <generator>'.
+// A translation unit should do one or the other, not both.
+//
+// The standard library headers used by <generator> are included in the
+// global module fragment so that they are not attached to this module;
+// <generator> itself is included in the module purview, where
+// __STDGENERATOR_EXPORT marks the declarations to export.
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+module;
+
+#if __has_include(<coroutine>)
+#include <coroutine>
+#else
+#include <experimental/coroutine>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#if __has_include(<ranges>)
+#include <ranges>
+#endif
+
+export module stdgenerator;
+
+#define __STDGENERATOR_EXPORT export
+#include <generator>
+
+export namespace std {
+using std::allocator_arg;
+using std::allocator_arg_t;
+using std::coroutine_traits;
+} // namespace std
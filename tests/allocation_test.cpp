@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+//
+// Counts heap allocations made by common generator patterns through a
+// replaced global operator new, so that changes which add heap traffic to
+// them are caught.
+//
+#include <generator>
+#include <experimental/frame_pool>
+#include <experimental/lifo_arena>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "check.hpp"
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    ::operator delete(p);
+}
+
+// Heap allocations made while evaluating f().
+template <typename F>
+std::size_t allocations_during(F&& f) {
+    const std::size_t before = allocations;
+    f();
+    return allocations - before;
+}
+
+// Checks that generators created and destroyed within one scope made n
+// heap allocations: one per frame and nothing else. GCC never elides
+// coroutine frames, so the count is exact there. Elsewhere frames may be
+// elided and only the bound is checked.
+void check_frame_allocations(std::size_t n, std::size_t frames) {
+#if defined(__GNUC__) && !defined(__clang__)
+    CHECK(n == frames);
+#else
+    CHECK(n <= frames);
+#endif
+}
+
+void test_local_generator_allocates_only_its_frame() {
+    int sum = 0;
+    auto run = [&] {
+        auto iota = [](int n) -> std::generator<int> {
+            for (int i = 0; i < n; ++i) {
+                co_yield i;
+            }
+        };
+        for (int x : iota(100)) {
+            sum += x;
+        }
+    };
+    check_frame_allocations(allocations_during(run), 1);
+    CHECK(sum == 4950);
+}
+
+void test_iteration_does_not_allocate() {
+    auto iota = [](int n) -> std::generator<int> {
+        for (int i = 0; i < n; ++i) {
+            co_yield i;
+        }
+    };
+    auto g = iota(1000);
+    auto it = g.begin();
+    int sum = 0;
+    auto run = [&] {
+        for (; it != g.end(); ++it) {
+            sum += *it;
+        }
+    };
+    CHECK(allocations_during(run) == 0);
+    CHECK(sum == 499500);
+}
+
+void test_elements_of_range_allocates_no_frame() {
+    const std::vector<int> values{1, 2, 3};
+    const std::array<int, 2> more{4, 5};
+    int sum = 0;
+    auto run = [&] {
+        auto gen = [&]() -> std::generator<const int&> {
+            co_yield std::ranges::elements_of(values);
+            co_yield std::ranges::elements_of(more);
+        };
+        for (int x : gen()) {
+            sum += x;
+        }
+    };
+    check_frame_allocations(allocations_during(run), 1);
+    CHECK(sum == 15);
+}
+
+void test_elements_of_generator_allocates_one_frame_each() {
+    int sum = 0;
+    auto run = [&] {
+        auto inner = [](int from) -> std::generator<int> {
+            co_yield from;
+            co_yield from + 1;
+        };
+        auto outer = [&]() -> std::generator<int> {
+            co_yield std::ranges::elements_of(inner(0));
+            co_yield std::ranges::elements_of(inner(2));
+        };
+        for (int x : outer()) {
+            sum += x;
+        }
+    };
+    check_frame_allocations(allocations_during(run), 3);
+    CHECK(sum == 6);
+}
+
+void test_drain_into_with_size_hint_allocates_once_for_storage() {
+    auto gen = []() -> std::generator<int> {
+        co_yield std::ranges::size_hint(1000);
+        for (int i = 0; i < 1000; ++i) {
+            co_yield i;
+        }
+    };
+    auto g = gen();
+    std::vector<int> out;
+    auto run = [&] {
+        g.drain_into(out);
+    };
+    CHECK(allocations_during(run) == 1);
+    CHECK(out.size() == 1000);
+}
+
+using pooled = std::experimental::frame_pool_allocator<std::byte>;
+
+std::generator<int, int, pooled> pooled_iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+std::generator<int, int, pooled> pooled_squares(std::generator<int, int, pooled> source) {
+    for (int x : source) {
+        co_yield x * x;
+    }
+}
+
+void test_pooled_pipeline_is_allocation_free_once_warm() {
+    int sum = 0;
+    auto run = [&] {
+        for (int x : pooled_squares(pooled_iota(10))) {
+            sum += x;
+        }
+    };
+    run();
+    sum = 0;
+    CHECK(allocations_during(run) == 0);
+    CHECK(sum == 285);
+}
+
+using arena = std::experimental::lifo_arena_allocator<std::byte>;
+
+std::generator<int, int, arena> arena_tree(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(arena_tree(depth - 1));
+        co_yield std::ranges::elements_of(arena_tree(depth - 1));
+    }
+}
+
+void test_arena_tree_walk_allocates_one_arena() {
+    int count = 0;
+    auto run = [&] {
+        for (int x : arena_tree(2)) {
+            (void)x;
+            ++count;
+        }
+    };
+    CHECK(allocations_during(run) == 1);
+    CHECK(count == 7);
+}
+
+int main() {
+    RUN(test_local_generator_allocates_only_its_frame);
+    RUN(test_iteration_does_not_allocate);
+    RUN(test_elements_of_range_allocates_no_frame);
+    RUN(test_elements_of_generator_allocates_one_frame_each);
+    RUN(test_drain_into_with_size_hint_allocates_once_for_storage);
+    RUN(test_pooled_pipeline_is_allocation_free_once_warm);
+    RUN(test_arena_tree_walk_allocates_one_arena);
+    return 0;
+}
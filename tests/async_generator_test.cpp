@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <experimental/async_generator>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+#include "event_loop.hpp"
+
+using std::experimental::async_generator;
+
+template <typename Ref>
+task<std::vector<std::remove_cvref_t<Ref>>> collect(async_generator<Ref> g) {
+    std::vector<std::remove_cvref_t<Ref>> values;
+    auto it = g.begin();
+    while (co_await it.next()) {
+        values.push_back(*it);
+    }
+    co_return values;
+}
+
+void test_producer_without_awaits() {
+    event_loop loop;
+    auto makeGen = []() -> async_generator<int> {
+        co_yield 1;
+        co_yield 2;
+        co_yield 3;
+    };
+
+    auto values = collect(makeGen()).run_on(loop);
+    CHECK((values == std::vector{1, 2, 3}));
+    CHECK(loop.resumptions == 0);
+}
+
+void test_producer_is_lazy() {
+    event_loop loop;
+    bool started = false;
+    auto makeGen = [&]() -> async_generator<int> {
+        started = true;
+        co_return;
+    };
+
+    auto g = makeGen();
+    auto it = g.begin();
+    CHECK(!started);
+
+    auto consume = [&]() -> task<bool> {
+        co_return co_await it.next();
+    };
+    CHECK(!consume().run_on(loop));
+    CHECK(started);
+}
+
+void test_producer_awaits_event_loop() {
+    event_loop loop;
+    auto makeGen = [&]() -> async_generator<int> {
+        for (int i = 0; i < 5; ++i) {
+            co_await loop.schedule();
+            co_yield i;
+        }
+    };
+
+    auto values = collect(makeGen()).run_on(loop);
+    CHECK((values == std::vector{0, 1, 2, 3, 4}));
+    CHECK(loop.resumptions == 5);
+}
+
+void test_producer_awaits_task() {
+    event_loop loop;
+    auto fetch = [&](int key) -> task<std::string> {
+        co_await loop.schedule();
+        co_return "value-" + std::to_string(key);
+    };
+    auto makeGen = [&]() -> async_generator<const std::string&> {
+        for (int key = 0; key < 3; ++key) {
+            std::string value = co_await fetch(key);
+            co_yield value;
+        }
+    };
+
+    auto values = collect(makeGen()).run_on(loop);
+    CHECK((values == std::vector<std::string>{"value-0", "value-1", "value-2"}));
+}
+
+void test_nested_elements_of() {
+    event_loop loop;
+    const std::vector<int> middle{3, 4};
+    auto inner = [&](int from) -> async_generator<int> {
+        co_await loop.schedule();
+        co_yield from;
+        co_await loop.schedule();
+        co_yield from + 1;
+    };
+    auto makeGen = [&]() -> async_generator<int> {
+        co_yield 0;
+        co_yield std::ranges::elements_of(inner(1));
+        co_yield std::ranges::elements_of(middle);
+        co_yield std::ranges::elements_of(inner(5));
+        co_yield 7;
+    };
+
+    auto values = collect(makeGen()).run_on(loop);
+    CHECK((values == std::vector{0, 1, 2, 3, 4, 5, 6, 7}));
+    CHECK(loop.resumptions == 4);
+}
+
+void test_exception_reaches_consumer() {
+    struct my_error : std::exception {};
+
+    event_loop loop;
+    auto makeGen = [&]() -> async_generator<int> {
+        co_yield 1;
+        co_await loop.schedule();
+        throw my_error{};
+    };
+
+    auto g = makeGen();
+    auto consume = [&]() -> task<int> {
+        int count = 0;
+        auto it = g.begin();
+        try {
+            while (co_await it.next()) {
+                ++count;
+            }
+        } catch (const my_error&) {
+            co_return -count;
+        }
+        co_return count;
+    };
+    CHECK(consume().run_on(loop) == -1);
+}
+
+void test_exception_from_nested_generator_reaches_parent() {
+    struct my_error : std::exception {};
+
+    event_loop loop;
+    auto inner = [&]() -> async_generator<int> {
+        co_yield 1;
+        co_await loop.schedule();
+        throw my_error{};
+    };
+    auto makeGen = [&]() -> async_generator<int> {
+        try {
+            co_yield std::ranges::elements_of(inner());
+            CHECK(false);
+        } catch (const my_error&) {
+        }
+        co_yield 2;
+    };
+
+    auto values = collect(makeGen()).run_on(loop);
+    CHECK((values == std::vector{1, 2}));
+}
+
+void test_destroying_generator_destroys_current_value() {
+    static int live = 0;
+    struct counted {
+        counted() { ++live; }
+        counted(const counted&) { ++live; }
+        ~counted() { --live; }
+    };
+
+    event_loop loop;
+    {
+        auto makeGen = [&]() -> async_generator<counted> {
+            co_await loop.schedule();
+            co_yield counted{};
+            co_yield counted{};
+        };
+        auto g = makeGen();
+        auto it = g.begin();
+        auto consume = [&]() -> task<bool> {
+            co_return co_await it.next();
+        };
+        CHECK(consume().run_on(loop));
+        // The yielded temporary and the generator's copy of it.
+        CHECK(live == 2);
+    }
+    CHECK(live == 0);
+}
+
+int main() {
+    RUN(test_producer_without_awaits);
+    RUN(test_producer_is_lazy);
+    RUN(test_producer_awaits_event_loop);
+    RUN(test_producer_awaits_task);
+    RUN(test_nested_elements_of);
+    RUN(test_exception_reaches_consumer);
+    RUN(test_exception_from_nested_generator_reaches_parent);
+    RUN(test_destroying_generator_destroys_current_value);
+    return 0;
+}
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/batch>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::batch;
+using std::experimental::batch_alignment;
+using std::experimental::for_each_batch;
+using std::experimental::unbatch;
+
+namespace {
+
+std::generator<float> iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield static_cast<float>(i);
+    }
+}
+
+bool aligned(const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p) % batch_alignment == 0;
+}
+
+void test_batch_yields_aligned_blocks() {
+    std::vector<std::size_t> sizes;
+    std::vector<float> values;
+    bool allAligned = true;
+    for (std::span<const float> block : batch(iota(10), 4)) {
+        sizes.push_back(block.size());
+        values.insert(values.end(), block.begin(), block.end());
+        allAligned = allAligned && aligned(block.data());
+    }
+    CHECK((sizes == std::vector<std::size_t>{4, 4, 2}));
+    CHECK((values == std::vector<float>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    CHECK(allAligned);
+}
+
+void test_batch_of_exact_multiple_and_empty() {
+    std::vector<std::size_t> sizes;
+    for (std::span<const float> block : batch(iota(8), 4)) {
+        sizes.push_back(block.size());
+    }
+    CHECK((sizes == std::vector<std::size_t>{4, 4}));
+
+    int blocks = 0;
+    for (std::span<const float> block : batch(iota(0), 4)) {
+        (void)block;
+        ++blocks;
+    }
+    CHECK(blocks == 0);
+}
+
+void test_batch_copies_contiguous_ranges_across_blocks() {
+    const std::vector<float> data{1, 2, 3, 4, 5, 6, 7};
+    auto gen = [&]() -> std::generator<const float&> {
+        co_yield 0.0f;
+        co_yield std::ranges::elements_of(data);
+        co_yield 8.0f;
+    };
+    std::vector<std::vector<float>> blocks;
+    for (std::span<const float> block : batch(gen(), 3)) {
+        blocks.emplace_back(block.begin(), block.end());
+    }
+    CHECK((blocks == std::vector<std::vector<float>>{{0, 1, 2}, {3, 4, 5}, {6, 7, 8}}));
+}
+
+void test_batch_moves_owned_values() {
+    auto strings = []() -> std::generator<std::string> {
+        co_yield std::string(100, 'a');
+        co_yield std::string(100, 'b');
+    };
+    std::vector<std::string> out;
+    for (std::span<const std::string> block : batch(strings(), 8)) {
+        out.assign(block.begin(), block.end());
+    }
+    CHECK((out == std::vector<std::string>{std::string(100, 'a'), std::string(100, 'b')}));
+}
+
+void test_unbatch_restores_values() {
+    std::vector<float> values;
+    for (float x : unbatch(batch(iota(10), 3))) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector<float>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+void test_for_each_batch_rounds_to_vectors() {
+    std::vector<std::size_t> sizes;
+    float sum = 0;
+    bool allAligned = true;
+    for_each_batch(iota(100), 10, [&](std::span<const float> block) {
+        sizes.push_back(block.size());
+        allAligned = allAligned && aligned(block.data());
+        for (float x : block) {
+            sum += x;
+        }
+    });
+    // 10 floats round up to one 64-byte vector of 16.
+    CHECK((sizes == std::vector<std::size_t>{16, 16, 16, 16, 16, 16, 4}));
+    CHECK(allAligned);
+    CHECK(sum == 4950.0f);
+}
+
+} // namespace
+
+int main() {
+    RUN(test_batch_yields_aligned_blocks);
+    RUN(test_batch_of_exact_multiple_and_empty);
+    RUN(test_batch_copies_contiguous_ranges_across_blocks);
+    RUN(test_batch_moves_owned_values);
+    RUN(test_unbatch_restores_values);
+    RUN(test_for_each_batch_rounds_to_vectors);
+    return 0;
+}
@@ -0,0 +1,224 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <experimental/buffered_generator>
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::buffered_generator;
+
+static_assert(std::ranges::input_range<buffered_generator<int>>);
+static_assert(std::ranges::view<buffered_generator<int>>);
+
+void test_empty_generator() {
+    auto g = []() -> buffered_generator<int, 4> {
+        co_return;
+    }();
+    CHECK(g.begin() == g.end());
+}
+
+void test_producer_fills_buffer_before_suspending() {
+    int produced = 0;
+    auto makeGen = [&]() -> buffered_generator<int, 4> {
+        for (int i = 0; i < 10; ++i) {
+            ++produced;
+            co_yield i;
+        }
+    };
+
+    auto g = makeGen();
+    CHECK(produced == 0);
+    auto it = g.begin();
+    CHECK(produced == 4);
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(it != g.end());
+        CHECK(*it == i);
+        ++it;
+    }
+    CHECK(produced == 8);
+
+    for (int i = 4; i < 10; ++i) {
+        CHECK(it != g.end());
+        CHECK(*it == i);
+        ++it;
+    }
+    CHECK(produced == 10);
+    CHECK(it == g.end());
+}
+
+void test_nested_elements_of() {
+    auto inner = [](int from) -> buffered_generator<std::string, 3> {
+        for (int i = from; i < from + 5; ++i) {
+            co_yield std::to_string(i);
+        }
+    };
+
+    const std::vector<std::string> letters{"b", "c"};
+    auto makeGen = [&]() -> buffered_generator<std::string, 3> {
+        co_yield "a";
+        co_yield std::ranges::elements_of(inner(0));
+        co_yield std::ranges::elements_of(letters);
+        co_yield std::ranges::elements_of(inner(10));
+        co_yield "d";
+    };
+
+    std::vector<std::string> values;
+    for (std::string& s : makeGen()) {
+        values.push_back(std::move(s));
+    }
+    CHECK((values == std::vector<std::string>{
+        "a", "0", "1", "2", "3", "4", "b", "c", "10", "11", "12", "13", "14", "d"}));
+}
+
+void test_buffered_values_delivered_before_exception() {
+    struct my_error : std::exception {};
+
+    auto g = []() -> buffered_generator<int, 8> {
+        co_yield 1;
+        co_yield 2;
+        throw my_error{};
+    }();
+
+    auto it = g.begin();
+    CHECK(*it == 1);
+    ++it;
+    CHECK(*it == 2);
+    bool caught = false;
+    try {
+        ++it;
+    } catch (const my_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+}
+
+void test_exception_from_nested_generator_reaches_parent() {
+    struct my_error : std::exception {};
+
+    auto g = []() -> buffered_generator<int, 2> {
+        try {
+            co_yield std::ranges::elements_of([]() -> buffered_generator<int, 2> {
+                co_yield 1;
+                co_yield 2;
+                co_yield 3;
+                throw my_error{};
+            }());
+            CHECK(false);
+        } catch (const my_error&) {
+        }
+        co_yield 4;
+    }();
+
+    std::vector<int> values;
+    for (int x : g) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{1, 2, 3, 4}));
+}
+
+void test_destroying_generator_destroys_buffered_values() {
+    static int live = 0;
+    struct counted {
+        counted() { ++live; }
+        counted(const counted&) { ++live; }
+        ~counted() { --live; }
+    };
+
+    {
+        auto g = []() -> buffered_generator<counted, 8> {
+            for (int i = 0; i < 5; ++i) {
+                co_yield counted{};
+            }
+        }();
+        auto it = g.begin();
+        ++it;
+        // Consumed values are destroyed when the buffer is next refilled.
+        CHECK(live == 5);
+    }
+    CHECK(live == 0);
+}
+
+// Records the size of the largest frame allocated through it.
+template <typename T>
+struct frame_size_allocator {
+    using value_type = T;
+
+    static inline std::size_t largest = 0;
+
+    frame_size_allocator() = default;
+    template <typename U>
+    frame_size_allocator(const frame_size_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        largest = std::max(largest, n * sizeof(T));
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    friend bool operator==(const frame_size_allocator&, const frame_size_allocator&) = default;
+};
+
+void test_frames_do_not_hold_buffer() {
+    using large_buffer = buffered_generator<int, 1024, frame_size_allocator<std::byte>>;
+    auto inner = []() -> large_buffer {
+        co_yield 1;
+    };
+    auto outer = [&]() -> large_buffer {
+        co_yield std::ranges::elements_of(inner());
+        co_yield 2;
+    };
+
+    std::vector<int> values;
+    for (int x : outer()) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{1, 2}));
+    CHECK(frame_size_allocator<std::byte>::largest > 0);
+    CHECK(frame_size_allocator<std::byte>::largest < 1024 * sizeof(int));
+}
+
+void test_moved_iterator_keeps_buffered_values() {
+    auto g = []() -> buffered_generator<std::string, 4> {
+        for (int i = 0; i < 6; ++i) {
+            co_yield std::to_string(i);
+        }
+    }();
+
+    auto it = g.begin();
+    ++it;
+    auto moved = std::move(it);
+    CHECK(it == g.end());
+
+    std::string joined;
+    for (; moved != g.end(); ++moved) {
+        joined += *moved;
+    }
+    CHECK(joined == "12345");
+}
+
+int main() {
+    RUN(test_empty_generator);
+    RUN(test_producer_fills_buffer_before_suspending);
+    RUN(test_nested_elements_of);
+    RUN(test_buffered_values_delivered_before_exception);
+    RUN(test_exception_from_nested_generator_reaches_parent);
+    RUN(test_destroying_generator_destroys_buffered_values);
+    RUN(test_frames_do_not_hold_buffer);
+    RUN(test_moved_iterator_keeps_buffered_values);
+    return 0;
+}
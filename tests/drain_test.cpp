@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+void test_drain_into_vector() {
+    auto g = []() -> std::generator<int> {
+        for (int i = 0; i < 100; ++i) {
+            co_yield i;
+        }
+    }();
+
+    std::vector<int> values;
+    g.drain_into(values);
+    CHECK(values.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        CHECK(values[i] == i);
+    }
+}
+
+void test_drain_into_after_begin() {
+    auto g = []() -> std::generator<int> {
+        co_yield 1;
+        co_yield 2;
+        co_yield 3;
+    }();
+
+    auto it = g.begin();
+    CHECK(*it == 1);
+    ++it;
+
+    std::deque<int> values;
+    g.drain_into(values);
+    CHECK((values == std::deque{2, 3}));
+}
+
+void test_drain_into_moves_values() {
+    auto g = []() -> std::generator<std::unique_ptr<int>> {
+        co_yield std::make_unique<int>(1);
+        co_yield std::make_unique<int>(2);
+    }();
+
+    std::vector<std::unique_ptr<int>> values;
+    g.drain_into(values);
+    CHECK(values.size() == 2);
+    CHECK(*values[0] == 1);
+    CHECK(*values[1] == 2);
+}
+
+void test_drain_into_does_not_move_from_yielded_lvalues() {
+    auto g = []() -> std::generator<std::string> {
+        std::string s = "a long string that does not fit in the small buffer";
+        co_yield s;
+        CHECK(s == "a long string that does not fit in the small buffer");
+        co_yield std::string("temporary");
+    }();
+
+    std::vector<std::string> values;
+    g.drain_into(values);
+    CHECK(values.size() == 2);
+    CHECK(values[0] == "a long string that does not fit in the small buffer");
+    CHECK(values[1] == "temporary");
+}
+
+void test_drain_into_copies_through_const_reference() {
+    const std::string s = "hello";
+    auto makeGen = [&]() -> std::generator<const std::string&> {
+        co_yield s;
+        co_yield s;
+    };
+
+    std::vector<std::string> values;
+    makeGen().drain_into(values);
+    CHECK((values == std::vector<std::string>{"hello", "hello"}));
+    CHECK(s == "hello");
+}
+
+void test_size_hint_reserves_capacity() {
+    auto g = []() -> std::generator<int> {
+        co_yield std::ranges::size_hint(1000);
+        for (int i = 0; i < 1000; ++i) {
+            co_yield i;
+        }
+    }();
+
+    std::vector<int> values;
+    g.drain_into(values);
+    CHECK(values.size() == 1000);
+    CHECK(values.capacity() == 1000);
+}
+
+void test_size_hint_is_ignored_by_iterator() {
+    auto g = []() -> std::generator<int> {
+        co_yield std::ranges::size_hint(2);
+        co_yield 1;
+        co_yield 2;
+    }();
+
+    std::vector<int> values;
+    for (int x : g) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{1, 2}));
+}
+
+void test_drain_into_nested_and_elements_of() {
+    const std::vector<int> tail{4, 5, 6};
+    auto inner = []() -> std::generator<int> {
+        co_yield std::ranges::size_hint(2);
+        co_yield 2;
+        co_yield 3;
+    };
+    auto makeGen = [&]() -> std::generator<int> {
+        co_yield 1;
+        co_yield std::ranges::elements_of(inner());
+        co_yield std::ranges::elements_of(tail);
+        co_yield 7;
+    };
+
+    std::vector<int> values;
+    makeGen().drain_into(values);
+    CHECK((values == std::vector{1, 2, 3, 4, 5, 6, 7}));
+}
+
+void test_drain_into_type_erased_allocator() {
+    auto g = [](std::allocator_arg_t, std::allocator<std::byte>) -> std::generator<int> {
+        co_yield 1;
+        co_yield 2;
+    }(std::allocator_arg, {});
+
+    std::vector<int> values;
+    g.drain_into(values);
+    CHECK((values == std::vector{1, 2}));
+}
+
+void test_drain_into_propagates_exception() {
+    struct my_error : std::exception {};
+
+    auto g = []() -> std::generator<int> {
+        co_yield 1;
+        throw my_error{};
+    }();
+
+    std::vector<int> values;
+    bool caught = false;
+    try {
+        g.drain_into(values);
+    } catch (const my_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK((values == std::vector{1}));
+}
+
+int main() {
+    RUN(test_drain_into_vector);
+    RUN(test_drain_into_after_begin);
+    RUN(test_drain_into_moves_values);
+    RUN(test_drain_into_does_not_move_from_yielded_lvalues);
+    RUN(test_drain_into_copies_through_const_reference);
+    RUN(test_size_hint_reserves_capacity);
+    RUN(test_size_hint_is_ignored_by_iterator);
+    RUN(test_drain_into_nested_and_elements_of);
+    RUN(test_drain_into_type_erased_allocator);
+    RUN(test_drain_into_propagates_exception);
+    return 0;
+}
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#ifndef EVENT_LOOP_HPP_INCLUDED
+#define EVENT_LOOP_HPP_INCLUDED
+
+#pragma once
+
+// Minimal single-threaded event loop and lazy task type for exercising
+// coroutines that suspend on something other than a generator.
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <utility>
+
+class event_loop {
+public:
+    struct schedule_awaiter {
+        event_loop& loop;
+
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { loop.ready.push_back(h); }
+        void await_resume() noexcept {}
+    };
+
+    // Suspends the awaiting coroutine and resumes it from run(), after any
+    // coroutines that were already queued.
+    schedule_awaiter schedule() noexcept {
+        return {*this};
+    }
+
+    // Resumes queued coroutines until the queue is empty.
+    void run() {
+        while (!ready.empty()) {
+            std::coroutine_handle<> h = ready.front();
+            ready.pop_front();
+            ++resumptions;
+            h.resume();
+        }
+    }
+
+    std::size_t resumptions = 0;
+
+private:
+    std::deque<std::coroutine_handle<>> ready;
+};
+
+// Lazily started task producing a T. Awaiting it starts it and resumes
+// the awaiter once it completes.
+template <typename T>
+class task {
+public:
+    struct promise_type {
+        std::optional<T> value;
+        std::exception_ptr exception;
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        task get_return_object() noexcept {
+            return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct final_awaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                return h.promise().continuation;
+            }
+            void await_resume() noexcept {}
+        };
+
+        final_awaiter final_suspend() noexcept { return {}; }
+
+        template <typename U>
+        void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    task(task&& other) noexcept : coro(std::exchange(other.coro, {})) {}
+
+    ~task() {
+        if (coro) {
+            coro.destroy();
+        }
+    }
+
+    auto operator co_await() noexcept {
+        struct awaiter {
+            std::coroutine_handle<promise_type> coro;
+
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) noexcept {
+                coro.promise().continuation = h;
+                return coro;
+            }
+            T await_resume() { return task::result(coro); }
+        };
+        return awaiter{coro};
+    }
+
+    // Starts the task and runs the loop until it has completed.
+    T run_on(event_loop& loop) {
+        coro.resume();
+        loop.run();
+        assert(coro.done());
+        return result(coro);
+    }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> h) noexcept : coro(h) {}
+
+    static T result(std::coroutine_handle<promise_type> h) {
+        if (h.promise().exception) {
+            std::rethrow_exception(h.promise().exception);
+        }
+        return std::move(*h.promise().value);
+    }
+
+    std::coroutine_handle<promise_type> coro;
+};
+
+#endif
@@ -0,0 +1,289 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/external_sort>
+#include <experimental/thread_pool>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::external_sort;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// A fresh, empty directory for spill files.
+fs::path spill_dir() {
+    const fs::path dir = fs::temp_directory_path() / "stdgenerator-external-sort-test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+std::size_t file_count(const fs::path& dir) {
+    return static_cast<std::size_t>(std::distance(fs::directory_iterator(dir), fs::directory_iterator()));
+}
+
+std::vector<std::uint32_t> random_values(std::size_t n) {
+    std::mt19937 rng(7);
+    std::vector<std::uint32_t> values(n);
+    for (auto& x : values) {
+        x = static_cast<std::uint32_t>(rng());
+    }
+    return values;
+}
+
+std::generator<std::uint32_t> values_of(const std::vector<std::uint32_t>& values) {
+    for (std::uint32_t x : values) {
+        co_yield x;
+    }
+}
+
+template <typename Gen>
+auto collect(Gen&& g) {
+    std::vector<std::remove_cvref_t<decltype(*g.begin())>> out;
+    for (auto&& x : g) {
+        out.push_back(x);
+    }
+    return out;
+}
+
+void test_small_input_is_sorted_in_memory() {
+    const fs::path dir = spill_dir();
+    const auto values = random_values(1000);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    auto sorted = external_sort(values_of(values), 1 << 20, dir);
+    auto it = sorted.begin();
+    CHECK(file_count(dir) == 0);
+    std::vector<std::uint32_t> out;
+    for (; it != sorted.end(); ++it) {
+        out.push_back(*it);
+    }
+    CHECK(out == expected);
+}
+
+void test_empty_input() {
+    const fs::path dir = spill_dir();
+    CHECK(collect(external_sort(values_of({}), 1 << 20, dir)).empty());
+}
+
+void test_spills_runs_and_removes_them() {
+    const fs::path dir = spill_dir();
+    // 512 KiB of values with a 256 KiB budget spills two runs.
+    const auto values = random_values(128 * 1024);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    auto sorted = external_sort(values_of(values), 256 * 1024, dir);
+    auto it = sorted.begin();
+    CHECK(file_count(dir) > 0);
+    std::vector<std::uint32_t> out;
+    for (; it != sorted.end(); ++it) {
+        out.push_back(*it);
+    }
+    CHECK(out == expected);
+    CHECK(file_count(dir) == 0);
+}
+
+void test_many_runs_are_merged_in_passes() {
+    const fs::path dir = spill_dir();
+    // The smallest budget merges at most two runs at once.
+    const auto values = random_values(300 * 1000);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    std::experimental::thread_pool pool(2);
+    CHECK(collect(external_sort(values_of(values), 0, dir, pool)) == expected);
+    CHECK(file_count(dir) == 0);
+}
+
+void test_truncated_run_is_reported_as_io_error() {
+    const fs::path dir = spill_dir();
+    const auto values = random_values(300 * 1000);
+    auto sorted = external_sort(values_of(values), 0, dir);
+    auto it = sorted.begin();
+    // Runs are read a buffer at a time, so the rest of each is read later.
+    for (const fs::directory_entry& entry : fs::directory_iterator(dir)) {
+        fs::resize_file(entry.path(), 0);
+    }
+
+    std::error_code error;
+    try {
+        for (; it != sorted.end(); ++it) {
+        }
+    } catch (const std::system_error& e) {
+        error = e.code();
+    }
+    CHECK(error == std::errc::io_error);
+}
+
+void test_destroying_generator_removes_spill_files() {
+    const fs::path dir = spill_dir();
+    const auto values = random_values(100 * 1000);
+    {
+        auto sorted = external_sort(values_of(values), 0, dir);
+        auto it = sorted.begin();
+        CHECK(file_count(dir) > 0);
+    }
+    CHECK(file_count(dir) == 0);
+}
+
+struct record {
+    std::string name;
+
+    friend bool operator<(const record& a, const record& b) {
+        return a.name < b.name;
+    }
+};
+
+// Trivially copyable, but not default constructible.
+struct key {
+    explicit key(std::uint32_t v) : value(v) {}
+    std::uint32_t value;
+
+    friend bool operator<(const key& a, const key& b) {
+        return a.value < b.value;
+    }
+};
+
+// Spilled like an int, but every read fails.
+struct unreadable {
+    int value;
+    std::string unused;
+
+    friend bool operator<(const unreadable& a, const unreadable& b) {
+        return a.value < b.value;
+    }
+};
+
+} // namespace
+
+template <>
+struct std::experimental::spill_traits<unreadable> {
+    static void write(std::FILE* file, const unreadable& u) {
+        std::fwrite(&u.value, sizeof(u.value), 1, file);
+    }
+
+    static unreadable read(std::FILE* file) {
+        // Writing to a stream opened for reading sets its error indicator.
+        std::fputc(0, file);
+        return unreadable{-1, {}};
+    }
+};
+
+template <>
+struct std::experimental::spill_traits<record> {
+    static void write(std::FILE* file, const record& r) {
+        const std::uint32_t size = static_cast<std::uint32_t>(r.name.size());
+        std::fwrite(&size, sizeof(size), 1, file);
+        std::fwrite(r.name.data(), 1, size, file);
+    }
+
+    static record read(std::FILE* file) {
+        std::uint32_t size = 0;
+        std::fread(&size, sizeof(size), 1, file);
+        record r{std::string(size, '\0')};
+        std::fread(r.name.data(), 1, size, file);
+        return r;
+    }
+};
+
+namespace {
+
+std::generator<record> records(std::size_t n) {
+    std::mt19937 rng(3);
+    for (std::size_t i = 0; i < n; ++i) {
+        record r{std::to_string(rng())};
+        co_yield std::move(r);
+    }
+}
+
+void test_user_serialised_values() {
+    const fs::path dir = spill_dir();
+    std::vector<std::string> expected;
+    for (auto&& r : records(20000)) {
+        expected.push_back(r.name);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::string> out;
+    for (auto&& r : external_sort(records(20000), 0, dir)) {
+        out.push_back(std::move(r.name));
+    }
+    CHECK(out == expected);
+    CHECK(file_count(dir) == 0);
+}
+
+void test_values_need_not_be_default_constructible() {
+    const fs::path dir = spill_dir();
+    const auto values = random_values(100 * 1000);
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    auto keys = [](const std::vector<std::uint32_t>& values) -> std::generator<key> {
+        for (std::uint32_t x : values) {
+            co_yield key{x};
+        }
+    };
+
+    std::vector<std::uint32_t> out;
+    for (const key& k : external_sort(keys(values), 0, dir)) {
+        out.push_back(k.value);
+    }
+    CHECK(out == expected);
+    CHECK(file_count(dir) == 0);
+}
+
+void test_read_error_is_reported_before_value() {
+    const fs::path dir = spill_dir();
+    auto values = []() -> std::generator<unreadable> {
+        for (int i = 0; i < 60000; ++i) {
+            unreadable u{i, {}};
+            co_yield std::move(u);
+        }
+    };
+
+    std::size_t received = 0;
+    bool threw = false;
+    try {
+        // A few runs, merged straight into the output.
+        for (auto&& u : external_sort(values(), 1 << 20, dir)) {
+            (void)u;
+            ++received;
+        }
+    } catch (const std::system_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(received == 0);
+    CHECK(file_count(dir) == 0);
+}
+
+} // namespace
+
+int main() {
+    RUN(test_small_input_is_sorted_in_memory);
+    RUN(test_empty_input);
+    RUN(test_spills_runs_and_removes_them);
+    RUN(test_many_runs_are_merged_in_passes);
+    RUN(test_truncated_run_is_reported_as_io_error);
+    RUN(test_destroying_generator_removes_spill_files);
+    RUN(test_user_serialised_values);
+    RUN(test_values_need_not_be_default_constructible);
+    RUN(test_read_error_is_reported_before_value);
+    fs::remove_all(fs::temp_directory_path() / "stdgenerator-external-sort-test");
+    return 0;
+}
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/flat_generator>
+#include <experimental/frame_pool>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::flat_generator;
+
+static_assert(std::ranges::input_range<flat_generator<int>>);
+static_assert(std::ranges::view<flat_generator<int>>);
+
+// The promise only holds the current value.
+static_assert(sizeof(flat_generator<int>::promise_type) <
+              sizeof(std::generator<int, int, std::allocator<std::byte>>::promise_type));
+static_assert(sizeof(flat_generator<const std::string&>::promise_type) == sizeof(void*));
+
+static_assert(noexcept(std::declval<flat_generator<int>::promise_type&>().unhandled_exception()));
+
+void test_yields_values() {
+    auto gen = []() -> flat_generator<int> {
+        for (int i = 0; i < 4; ++i) {
+            co_yield i;
+        }
+    };
+    std::vector<int> values;
+    for (int x : gen()) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{0, 1, 2, 3}));
+}
+
+void test_empty() {
+    auto gen = []() -> flat_generator<int> {
+        co_return;
+    };
+    auto g = gen();
+    CHECK(g.begin() == g.end());
+}
+
+void test_reference_type() {
+    std::string stored = "stored";
+    auto gen = [&]() -> flat_generator<std::string&> {
+        co_yield stored;
+    };
+    for (std::string& s : gen()) {
+        CHECK(&s == &stored);
+        s = "modified";
+    }
+    CHECK(stored == "modified");
+}
+
+void test_yield_converts_to_value_type() {
+    auto gen = []() -> flat_generator<std::string> {
+        co_yield "converted";
+        const std::string lvalue = "copied";
+        co_yield lvalue;
+    };
+    std::vector<std::string> values;
+    for (std::string s : gen()) {
+        values.push_back(s);
+    }
+    CHECK((values == std::vector<std::string>{"converted", "copied"}));
+}
+
+void test_move_only_values() {
+    auto gen = []() -> flat_generator<std::unique_ptr<int>&&> {
+        co_yield std::make_unique<int>(1);
+        co_yield std::make_unique<int>(2);
+    };
+    int sum = 0;
+    for (auto&& p : gen()) {
+        std::unique_ptr<int> owned = std::move(p);
+        sum += *owned;
+    }
+    CHECK(sum == 3);
+}
+
+void test_destroying_suspended_generator_destroys_value() {
+    static int live = 0;
+    struct counted {
+        counted() { ++live; }
+        counted(const counted&) { ++live; }
+        ~counted() { --live; }
+    };
+    {
+        auto gen = []() -> flat_generator<counted> {
+            co_yield counted{};
+            co_yield counted{};
+        };
+        auto g = gen();
+        auto it = g.begin();
+        CHECK(it != g.end());
+    }
+    CHECK(live == 0);
+}
+
+void test_allocator_parameter() {
+    auto gen = []() -> flat_generator<int, int, std::experimental::frame_pool_allocator<std::byte>> {
+        co_yield 7;
+    };
+    int sum = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (int x : gen()) {
+            sum += x;
+        }
+    }
+    CHECK(sum == 21);
+}
+
+void test_nested_in_generator_via_elements_of() {
+    auto leaf = [](int from) -> flat_generator<int> {
+        co_yield from;
+        co_yield from + 1;
+    };
+    auto outer = [&]() -> std::generator<int> {
+        co_yield std::ranges::elements_of(leaf(0));
+        co_yield std::ranges::elements_of(leaf(2));
+    };
+    std::vector<int> values;
+    for (int x : outer()) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{0, 1, 2, 3}));
+}
+
+void test_works_with_views() {
+    auto gen = []() -> flat_generator<int> {
+        for (int i = 0; i < 10; ++i) {
+            co_yield i;
+        }
+    };
+    std::vector<int> values;
+    for (int x : gen() | std::views::filter([](int x) { return x % 3 == 0; })) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{0, 3, 6, 9}));
+}
+
+int main() {
+    RUN(test_yields_values);
+    RUN(test_empty);
+    RUN(test_reference_type);
+    RUN(test_yield_converts_to_value_type);
+    RUN(test_move_only_values);
+    RUN(test_destroying_suspended_generator_destroys_value);
+    RUN(test_allocator_parameter);
+    RUN(test_nested_in_generator_via_elements_of);
+    RUN(test_works_with_views);
+    return 0;
+}
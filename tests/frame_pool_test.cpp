@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/frame_pool>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::frame_pool_allocator;
+
+// A stateless allocator must not be stored in the coroutine frame.
+static_assert(!std::__allocator_needs_to_be_stored<frame_pool_allocator<std::byte>>);
+
+void test_freed_block_is_reused_for_same_size() {
+    frame_pool_allocator<std::byte> alloc;
+    std::byte* p = alloc.allocate(100);
+    alloc.deallocate(p, 100);
+    std::byte* q = alloc.allocate(100);
+    CHECK(p == q);
+    std::byte* r = alloc.allocate(100);
+    CHECK(r != q);
+    alloc.deallocate(q, 100);
+    alloc.deallocate(r, 100);
+}
+
+void test_large_allocations_bypass_pool() {
+    frame_pool_allocator<std::byte> alloc;
+    std::byte* p = alloc.allocate(64 * 1024);
+    p[0] = std::byte{1};
+    p[64 * 1024 - 1] = std::byte{2};
+    alloc.deallocate(p, 64 * 1024);
+}
+
+void test_generator_allocator_parameter() {
+    auto g = []() -> std::generator<int, int, frame_pool_allocator<std::byte>> {
+        co_yield 1;
+        co_yield std::ranges::elements_of([]() -> std::generator<int, int, frame_pool_allocator<std::byte>> {
+            co_yield 2;
+        }());
+        co_yield 3;
+    }();
+
+    std::vector<int> values;
+    for (int x : g) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{1, 2, 3}));
+}
+
+void test_generator_allocator_arg() {
+    auto g = [](std::allocator_arg_t, frame_pool_allocator<std::byte>) -> std::generator<int> {
+        co_yield 42;
+    }(std::allocator_arg, {});
+
+    auto it = g.begin();
+    CHECK(it != g.end());
+    CHECK(*it == 42);
+    ++it;
+    CHECK(it == g.end());
+}
+
+using pooled_generator = std::generator<int, int, frame_pool_allocator<std::byte>>;
+
+pooled_generator make_pooled(int x) {
+    co_yield x;
+}
+
+void test_frames_destroyed_on_another_thread() {
+    std::vector<pooled_generator> gens;
+    for (int i = 0; i < 100; ++i) {
+        gens.push_back(make_pooled(i));
+    }
+
+    std::thread t([&] {
+        int expected = 0;
+        for (auto& g : gens) {
+            for (int x : g) {
+                CHECK(x == expected);
+            }
+            ++expected;
+        }
+        gens.clear();
+    });
+    t.join();
+
+    // The remotely freed frames are reclaimed by this thread's pool.
+    for (int i = 0; i < 100; ++i) {
+        for (int x : make_pooled(i)) {
+            CHECK(x == i);
+        }
+    }
+}
+
+void test_frames_outlive_allocating_thread() {
+    std::vector<pooled_generator> gens;
+    std::thread t([&] {
+        for (int i = 0; i < 100; ++i) {
+            gens.push_back(make_pooled(i));
+        }
+    });
+    t.join();
+
+    int expected = 0;
+    for (auto& g : gens) {
+        for (int x : g) {
+            CHECK(x == expected);
+        }
+        ++expected;
+    }
+    gens.clear();
+}
+
+int main() {
+    RUN(test_freed_block_is_reused_for_same_size);
+    RUN(test_large_allocations_bypass_pool);
+    RUN(test_generator_allocator_parameter);
+    RUN(test_generator_allocator_arg);
+    RUN(test_frames_destroyed_on_another_thread);
+    RUN(test_frames_outlive_allocating_thread);
+    return 0;
+}
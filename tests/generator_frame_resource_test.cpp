@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/generator_frame_resource>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::generator_frame_resource;
+
+namespace {
+
+// Upstream resource that counts what is allocated from it.
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        ++outstanding;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        --outstanding;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// GCC pairs the frame's templated placement operator new with the class's
+// sized operator delete as a mismatch when not optimising, although the
+// delete is the one the coroutine must call.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+std::pmr::generator<int> tree(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc,
+                              int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(tree(std::allocator_arg, alloc, depth - 1));
+        co_yield std::ranges::elements_of(tree(std::allocator_arg, alloc, depth - 1));
+    }
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+int sum(std::pmr::generator<int> g) {
+    int total = 0;
+    for (int x : g) {
+        total += x;
+    }
+    return total;
+}
+
+void test_pmr_generator_uses_default_resource() {
+    counting_resource upstream;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&upstream);
+    {
+        auto g = []() -> std::pmr::generator<int> {
+            co_yield 1;
+            co_yield 2;
+        }();
+        CHECK(upstream.outstanding == 1);
+        CHECK(sum(std::move(g)) == 3);
+    }
+    std::pmr::set_default_resource(previous);
+    CHECK(upstream.outstanding == 0);
+}
+
+void test_nested_frames_come_from_resource() {
+    counting_resource upstream;
+    generator_frame_resource resource(&upstream);
+    CHECK(resource.upstream_resource() == &upstream);
+
+    // The at most six live frames of a depth-5 tree fit in the first chunk.
+    CHECK(sum(tree(std::allocator_arg, &resource, 5)) == 57);
+    CHECK(upstream.allocations == 1);
+
+    // Later trees reuse the freed frames.
+    for (int i = 0; i < 100; ++i) {
+        CHECK(sum(tree(std::allocator_arg, &resource, 5)) == 57);
+    }
+    CHECK(upstream.allocations == 1);
+
+    resource.release();
+    CHECK(upstream.outstanding == 0);
+}
+
+void test_freed_block_is_reused_for_same_size() {
+    generator_frame_resource resource;
+    void* p = resource.allocate(200);
+    resource.deallocate(p, 200);
+    void* q = resource.allocate(200);
+    CHECK(p == q);
+    void* r = resource.allocate(200);
+    CHECK(r != q);
+    // A different size class does not reuse the block.
+    resource.deallocate(q, 200);
+    void* s = resource.allocate(300);
+    CHECK(s != q);
+    resource.deallocate(r, 200);
+    resource.deallocate(s, 300);
+}
+
+void test_chunks_grow_and_are_released() {
+    counting_resource upstream;
+    {
+        generator_frame_resource resource(&upstream);
+        std::vector<void*> blocks;
+        for (int i = 0; i < 1000; ++i) {
+            blocks.push_back(resource.allocate(64));
+        }
+        // 64000 bytes need chunks of 4, 8, 16, 32 and 64 KiB.
+        CHECK(upstream.allocations == 5);
+        for (void* p : blocks) {
+            resource.deallocate(p, 64);
+        }
+        CHECK(upstream.outstanding == 5);
+    }
+    CHECK(upstream.outstanding == 0);
+}
+
+void test_large_and_overaligned_requests_go_upstream() {
+    counting_resource upstream;
+    generator_frame_resource resource(&upstream);
+    void* p = resource.allocate(64 * 1024);
+    CHECK(upstream.outstanding == 1);
+    void* q = resource.allocate(64, 64);
+    CHECK(upstream.outstanding == 2);
+    resource.deallocate(p, 64 * 1024);
+    resource.deallocate(q, 64, 64);
+    CHECK(upstream.outstanding == 0);
+}
+
+} // namespace
+
+int main() {
+    RUN(test_pmr_generator_uses_default_resource);
+    RUN(test_nested_frames_come_from_resource);
+    RUN(test_freed_block_is_reused_for_same_size);
+    RUN(test_chunks_grow_and_are_released);
+    RUN(test_large_and_overaligned_requests_go_upstream);
+    return 0;
+}
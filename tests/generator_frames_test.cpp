@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#define STDGENERATOR_FRAME_REGISTRY
+
+#include <generator>
+#include <experimental/flat_generator>
+#include <experimental/generator_frames>
+#include <experimental/lifo_arena>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::frame_size;
+using std::experimental::generator_frame_info;
+using std::experimental::generator_frame_report;
+
+static_assert(std::experimental::generator_frame_registry_enabled);
+
+namespace {
+
+std::generator<int> small_frame(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+// The buffer is held across the co_yield, so it lives in the frame.
+std::generator<int> large_frame(int n) {
+    char buffer[4096] = {};
+    for (int i = 0; i < n; ++i) {
+        buffer[i % sizeof(buffer)] = static_cast<char>(i);
+        co_yield buffer[i % sizeof(buffer)];
+    }
+}
+
+std::generator<int> nested_frame() {
+    co_yield std::ranges::elements_of(small_frame(2));
+}
+
+std::generator<int, int, std::experimental::lifo_arena_allocator<std::byte>> arena_frame() {
+    co_yield 1;
+}
+
+std::experimental::flat_generator<int> unregistered_frame() {
+    co_yield 1;
+}
+
+// The report entry for the coroutine whose name contains function.
+const generator_frame_info* find(const std::vector<generator_frame_info>& report,
+                                 const char* function) {
+    for (const generator_frame_info& info : report) {
+        if (std::strstr(info.function, function) != nullptr) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+void test_frame_size_of_generator() {
+    auto small = small_frame(1);
+    auto large = large_frame(1);
+    CHECK(frame_size(small) > 0);
+    CHECK(frame_size(large) > 4096);
+    CHECK(frame_size(large) > frame_size(small));
+
+    auto moved = std::move(small);
+    CHECK(frame_size(moved) > 0);
+    CHECK(frame_size(small) == 0);
+
+    auto arena = arena_frame();
+    CHECK(frame_size(arena) > 0);
+}
+
+void test_report_counts_live_frames_per_call_site() {
+    {
+        std::vector<std::generator<int>> gens;
+        for (int i = 0; i < 3; ++i) {
+            gens.push_back(large_frame(1));
+        }
+        const auto report = generator_frame_report();
+        const generator_frame_info* info = find(report, "large_frame");
+        CHECK(info != nullptr);
+        CHECK(info->live_frames == 3);
+        CHECK(info->frame_size == frame_size(gens[0]));
+        CHECK(std::strstr(info->file, "generator_frames_test") != nullptr);
+        CHECK(std::strstr(info->promise_type, "generator") != nullptr);
+    }
+    const auto report = generator_frame_report();
+    const generator_frame_info* info = find(report, "large_frame");
+    CHECK(info != nullptr);
+    CHECK(info->live_frames == 0);
+    CHECK(info->frames_allocated >= 3);
+}
+
+void test_nested_generators_have_their_own_site() {
+    std::size_t before = 0;
+    const auto earlier = generator_frame_report();
+    if (const generator_frame_info* info = find(earlier, "small_frame")) {
+        before = info->frames_allocated;
+    }
+    int sum = 0;
+    for (int x : nested_frame()) {
+        sum += x;
+    }
+    CHECK(sum == 1);
+    const auto report = generator_frame_report();
+    CHECK(find(report, "nested_frame") != nullptr);
+    const generator_frame_info* small = find(report, "small_frame");
+    CHECK(small != nullptr);
+    CHECK(small->frames_allocated == before + 1);
+}
+
+void test_report_is_sorted_by_frame_size() {
+    auto large = large_frame(1);
+    auto small = small_frame(1);
+    const auto report = generator_frame_report();
+    CHECK(report.size() >= 2);
+    CHECK(std::is_sorted(report.begin(), report.end(),
+                         [](const generator_frame_info& a, const generator_frame_info& b) {
+                             return a.frame_size > b.frame_size;
+                         }));
+
+    std::ostringstream out;
+    std::experimental::write_generator_frame_report(out);
+    const std::string text = out.str();
+    CHECK(text.find("frame bytes") == 0);
+    CHECK(text.find("large_frame") < text.find("small_frame"));
+}
+
+} // namespace
+
+void test_unregistered_frames_leave_no_size_behind() {
+    // A promise that does not register its frame must not leave its size
+    // for the next std::generator on this thread to record.
+    auto g = unregistered_frame();
+    CHECK(std::__generator_frames::__last_size_ == 0);
+}
+
+int main() {
+    RUN(test_frame_size_of_generator);
+    RUN(test_report_counts_live_frames_per_call_site);
+    RUN(test_nested_generators_have_their_own_site);
+    RUN(test_report_is_sorted_by_frame_size);
+    RUN(test_unregistered_frames_leave_no_size_behind);
+    return 0;
+}
@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#define STDGENERATOR_INSTRUMENTATION
+
+#include <generator>
+#include <experimental/generator_stats>
+#include <experimental/lifo_arena>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::generator_stats;
+using std::experimental::reset_this_thread_generator_stats;
+using std::experimental::this_thread_generator_stats;
+
+static_assert(generator_stats::enabled);
+
+std::generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+void test_counts_resumes_and_frames() {
+    reset_this_thread_generator_stats();
+    {
+        auto g = iota(3);
+        CHECK(this_thread_generator_stats().frames_allocated == 1);
+        CHECK(this_thread_generator_stats().frame_bytes_allocated > 0);
+        for (int x : g) {
+            (void)x;
+        }
+    }
+    generator_stats stats = this_thread_generator_stats();
+    // begin(), then one increment per value.
+    CHECK(stats.resumes == 4);
+    CHECK(stats.frames_allocated == 1);
+    CHECK(stats.frames_freed == 1);
+    CHECK(stats.nested_entries == 0);
+    CHECK(stats.max_depth == 0);
+}
+
+std::generator<int> tree(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(tree(depth - 1));
+        co_yield std::ranges::elements_of(tree(depth - 1));
+    }
+}
+
+void test_counts_nesting_and_max_depth() {
+    reset_this_thread_generator_stats();
+    int count = 0;
+    for (int x : tree(3)) {
+        (void)x;
+        ++count;
+    }
+    CHECK(count == 15);
+
+    generator_stats stats = this_thread_generator_stats();
+    CHECK(stats.frames_allocated == 15);
+    CHECK(stats.frames_freed == 15);
+    CHECK(stats.nested_entries == 14);
+    CHECK(stats.nested_exits == 14);
+    CHECK(stats.max_depth == 3);
+    CHECK(stats.exceptions_transferred == 0);
+}
+
+void test_elements_of_range_is_not_nested() {
+    reset_this_thread_generator_stats();
+    const std::vector<int> values{1, 2, 3};
+    auto gen = [&]() -> std::generator<const int&> {
+        co_yield std::ranges::elements_of(values);
+    };
+    for (int x : gen()) {
+        (void)x;
+    }
+    generator_stats stats = this_thread_generator_stats();
+    CHECK(stats.frames_allocated == 1);
+    CHECK(stats.nested_entries == 0);
+}
+
+void test_counts_exceptions_transferred_to_parent() {
+    struct my_error : std::exception {};
+
+    reset_this_thread_generator_stats();
+    auto inner = []() -> std::generator<int> {
+        co_yield 1;
+        throw my_error{};
+    };
+    auto outer = [&]() -> std::generator<int> {
+        try {
+            co_yield std::ranges::elements_of(inner());
+        } catch (const my_error&) {
+        }
+        co_yield 2;
+    };
+    std::vector<int> values;
+    for (int x : outer()) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{1, 2}));
+    CHECK(this_thread_generator_stats().exceptions_transferred == 1);
+    CHECK(this_thread_generator_stats().nested_exits == 1);
+}
+
+void test_drain_into_counts_resumes() {
+    reset_this_thread_generator_stats();
+    std::vector<int> out;
+    iota(5).drain_into(out);
+    CHECK(out.size() == 5);
+    CHECK(this_thread_generator_stats().resumes == 6);
+}
+
+std::generator<int, int, std::experimental::lifo_arena_allocator<std::byte>> arena_iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+void test_counts_frames_from_custom_allocators() {
+    reset_this_thread_generator_stats();
+    for (int x : arena_iota(2)) {
+        (void)x;
+    }
+    CHECK(this_thread_generator_stats().frames_allocated == 1);
+    CHECK(this_thread_generator_stats().frames_freed == 1);
+}
+
+void test_counters_are_per_thread() {
+    reset_this_thread_generator_stats();
+    for (int x : iota(2)) {
+        (void)x;
+    }
+    std::size_t otherResumes = 0;
+    std::thread t([&] {
+        otherResumes = this_thread_generator_stats().resumes;
+        for (int x : iota(10)) {
+            (void)x;
+        }
+    });
+    t.join();
+    CHECK(otherResumes == 0);
+    CHECK(this_thread_generator_stats().resumes == 3);
+}
+
+int main() {
+    RUN(test_counts_resumes_and_frames);
+    RUN(test_counts_nesting_and_max_depth);
+    RUN(test_elements_of_range_is_not_nested);
+    RUN(test_counts_exceptions_transferred_to_parent);
+    RUN(test_drain_into_counts_resumes);
+    RUN(test_counts_frames_from_custom_allocators);
+    RUN(test_counters_are_per_thread);
+    return 0;
+}
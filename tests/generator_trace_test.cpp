@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#define STDGENERATOR_TRACING
+
+#include <generator>
+#include <experimental/generator_trace>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::clear_generator_trace;
+using std::experimental::enable_generator_tracing;
+using std::experimental::write_generator_trace;
+
+static std::string trace() {
+    std::ostringstream out;
+    write_generator_trace(out);
+    return out.str();
+}
+
+static std::size_t count(const std::string& text, const std::string& pattern) {
+    std::size_t n = 0;
+    for (auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+std::generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+void test_empty_trace_is_valid_json_object() {
+    clear_generator_trace();
+    CHECK(trace() == "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n");
+}
+
+void test_records_resume_and_suspend_pairs() {
+    clear_generator_trace();
+    for (int x : iota(3)) {
+        (void)x;
+    }
+    const std::string t = trace();
+    // begin() and three increments, the last of which completes the root.
+    CHECK(count(t, "\"ph\":\"B\"") == 4);
+    CHECK(count(t, "\"ph\":\"E\"") == 4);
+    CHECK(count(t, "\"depth\":0") == 8);
+}
+
+std::generator<int> chain(int depth) {
+    co_yield depth;
+    if (depth > 0) {
+        co_yield std::ranges::elements_of(chain(depth - 1));
+    }
+}
+
+void test_records_nesting_with_depth() {
+    clear_generator_trace();
+    std::vector<int> values;
+    for (int x : chain(2)) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{2, 1, 0}));
+
+    const std::string t = trace();
+    CHECK(count(t, "\"name\":\"enter\"") == 2);
+    CHECK(count(t, "\"name\":\"exit\"") == 2);
+    // The value 0 is yielded at depth 2, so that suspension is recorded
+    // with the leaf's depth.
+    CHECK(count(t, "\"ph\":\"E\",\"pid\":1") == 4);
+    CHECK(t.find("\"depth\":2") != std::string::npos);
+}
+
+void test_disabled_tracing_records_nothing() {
+    clear_generator_trace();
+    enable_generator_tracing(false);
+    for (int x : iota(3)) {
+        (void)x;
+    }
+    enable_generator_tracing(true);
+    CHECK(count(trace(), "\"ph\"") == 0);
+}
+
+void test_threads_get_their_own_track() {
+    clear_generator_trace();
+    for (int x : iota(1)) {
+        (void)x;
+    }
+    std::thread t([] {
+        for (int x : iota(1)) {
+            (void)x;
+        }
+    });
+    t.join();
+    const std::string text = trace();
+    CHECK(count(text, "\"ph\":\"B\"") == 4);
+    CHECK(count(text, "\"tid\":1,") == 4);
+    CHECK(count(text, "\"tid\":2,") == 4);
+}
+
+void test_ring_keeps_most_recent_events() {
+    clear_generator_trace();
+    const int values = static_cast<int>(std::__trace_ring::__capacity);
+    for (int x : iota(values)) {
+        (void)x;
+    }
+    const std::string t = trace();
+    CHECK(count(t, "\"ph\"") == std::__trace_ring::__capacity);
+    // The most recent event is the completion of the root.
+    CHECK(t.rfind("\"ph\":\"E\"") > t.rfind("\"ph\":\"B\""));
+}
+
+int main() {
+    RUN(test_empty_trace_is_valid_json_object);
+    RUN(test_records_resume_and_suspend_pairs);
+    RUN(test_records_nesting_with_depth);
+    RUN(test_disabled_tracing_records_nothing);
+    RUN(test_threads_get_their_own_track);
+    RUN(test_ring_keeps_most_recent_events);
+    return 0;
+}
@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/lifo_arena>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+// Count calls to the global allocation function so we can tell whether
+// nested frames were placed in the root's arena.
+static std::size_t globalAllocationCount = 0;
+
+void* operator new(std::size_t size) {
+    ++globalAllocationCount;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using arena_generator = std::generator<int, int, std::experimental::lifo_arena_allocator<std::byte>>;
+
+struct node {
+    int value;
+    std::vector<node> children;
+};
+
+node make_tree(int depth, int& next) {
+    node n{next++, {}};
+    if (depth > 0) {
+        n.children.push_back(make_tree(depth - 1, next));
+        n.children.push_back(make_tree(depth - 1, next));
+    }
+    return n;
+}
+
+arena_generator walk(const node& n) {
+    co_yield n.value;
+    for (const node& child : n.children) {
+        co_yield std::ranges::elements_of(walk(child));
+    }
+}
+
+void test_recursive_walk_shares_root_arena() {
+    int next = 0;
+    const node tree = make_tree(8, next);
+    const int nodeCount = next;
+
+    const std::size_t before = globalAllocationCount;
+    int expected = 0;
+    for (int x : walk(tree)) {
+        CHECK(x == expected);
+        ++expected;
+    }
+    CHECK(expected == nodeCount);
+
+    // One allocation for the root arena, plus a handful of chunks. Without
+    // the arena every one of the 511 frames would hit the global heap.
+    CHECK(globalAllocationCount - before < 8);
+}
+
+void test_deep_recursion_grows_arena() {
+    auto chain = [](auto& self, int depth) -> arena_generator {
+        co_yield depth;
+        if (depth > 0) {
+            co_yield std::ranges::elements_of(self(self, depth - 1));
+        }
+    };
+
+    int expected = 1000;
+    for (int x : chain(chain, 1000)) {
+        CHECK(x == expected);
+        --expected;
+    }
+    CHECK(expected == -1);
+
+    // Iterate again so the spare chunks get reused.
+    expected = 1000;
+    for (int x : chain(chain, 1000)) {
+        CHECK(x == expected);
+        --expected;
+    }
+    CHECK(expected == -1);
+}
+
+void test_frames_freed_out_of_order() {
+    auto leaf = [](int x) -> arena_generator {
+        co_yield x;
+    };
+
+    auto makeGen = [&]() -> arena_generator {
+        std::vector<arena_generator> gens;
+        for (int i = 0; i < 10; ++i) {
+            gens.push_back(leaf(i));
+        }
+        // Destroy the oldest frames first.
+        for (int i = 0; i < 10; ++i) {
+            for (int x : gens[i]) {
+                co_yield x;
+            }
+            gens[i] = arena_generator{};
+        }
+        co_yield std::ranges::elements_of(leaf(10));
+    };
+
+    auto g = makeGen();
+    int expected = 0;
+    for (int x : g) {
+        CHECK(x == expected);
+        ++expected;
+    }
+    CHECK(expected == 11);
+}
+
+void test_generator_outlives_root() {
+    auto leaf = [](int x) -> arena_generator {
+        co_yield x;
+        co_yield x + 1;
+    };
+
+    arena_generator escaped;
+    {
+        auto makeRoot = [&]() -> arena_generator {
+            escaped = leaf(42);
+            co_yield 1;
+        };
+        auto root = makeRoot();
+        for (int x : root) {
+            CHECK(x == 1);
+        }
+    }
+
+    std::vector<int> values;
+    for (int x : escaped) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{42, 43}));
+}
+
+void test_independent_roots() {
+    const node first{1, {}};
+    const node second{2, {}};
+    auto a = walk(first);
+    auto b = walk(second);
+    auto ita = a.begin();
+    auto itb = b.begin();
+    CHECK(*ita == 1);
+    CHECK(*itb == 2);
+    ++ita;
+    ++itb;
+    CHECK(ita == a.end());
+    CHECK(itb == b.end());
+}
+
+// A frame whose allocation the compiler elided lives outside every arena;
+// stands in for one with a promise base on the stack.
+void test_elided_frame_has_no_arena() {
+    using promise_base = std::__promise_base_alloc<std::experimental::lifo_arena_allocator<std::byte>>;
+
+    // The most recent arena, and its block, are freed again.
+    {
+        const node n{1, {}};
+        for (int x : walk(n)) {
+            CHECK(x == 1);
+        }
+    }
+    {
+        promise_base onStack;
+        promise_base::__resume_guard guard{onStack};
+        CHECK(std::experimental::__lifo_arena::__current_ == nullptr);
+    }
+
+    // Nor does it pick up the arena of a frame that is still alive.
+    const node n{2, {}};
+    auto g = walk(n);
+    promise_base onStack;
+    promise_base::__resume_guard guard{onStack};
+    CHECK(std::experimental::__lifo_arena::__current_ == nullptr);
+}
+
+int main() {
+    RUN(test_recursive_walk_shares_root_arena);
+    RUN(test_deep_recursion_grows_arena);
+    RUN(test_frames_freed_out_of_order);
+    RUN(test_generator_outlives_root);
+    RUN(test_independent_roots);
+    RUN(test_elided_frame_has_no_arena);
+    return 0;
+}
@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/merge>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::merge;
+
+std::generator<int> values_of(std::vector<int> values) {
+    for (int x : values) {
+        co_yield x;
+    }
+}
+
+template <typename Gen>
+auto collect(Gen&& g) {
+    std::vector<std::remove_cvref_t<decltype(*g.begin())>> out;
+    for (auto&& x : g) {
+        out.push_back(x);
+    }
+    return out;
+}
+
+void test_merges_generators() {
+    CHECK((collect(merge(values_of({1, 4, 7}), values_of({2, 5, 8}), values_of({0, 3, 6, 9}))) ==
+           std::vector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+void test_single_and_empty_inputs() {
+    CHECK((collect(merge(values_of({3, 5}))) == std::vector{3, 5}));
+    CHECK((collect(merge(values_of({}), values_of({2}), values_of({}))) == std::vector{2}));
+
+    std::vector<std::generator<int>> none;
+    CHECK(collect(merge(none)).empty());
+}
+
+void test_merges_range_of_many_generators() {
+    std::mt19937 rng(42);
+    std::vector<int> expected;
+    std::vector<std::generator<int>> shards;
+    for (int shard = 0; shard < 300; ++shard) {
+        std::vector<int> values(rng() % 20);
+        for (int& x : values) {
+            x = static_cast<int>(rng() % 1000);
+        }
+        std::sort(values.begin(), values.end());
+        expected.insert(expected.end(), values.begin(), values.end());
+        shards.push_back(values_of(std::move(values)));
+    }
+    std::sort(expected.begin(), expected.end());
+    CHECK(collect(merge(shards)) == expected);
+}
+
+struct entry {
+    int key;
+    int shard;
+
+    friend bool operator<(const entry& a, const entry& b) {
+        return a.key < b.key;
+    }
+};
+
+std::generator<const entry&> entries(int shard, std::vector<int> keys) {
+    for (int key : keys) {
+        const entry e{key, shard};
+        co_yield e;
+    }
+}
+
+void test_ties_keep_input_order() {
+    std::vector<std::pair<int, int>> order;
+    for (const entry& e : merge(entries(0, {1, 2, 2}), entries(1, {1, 2}), entries(2, {2}))) {
+        order.emplace_back(e.key, e.shard);
+    }
+    CHECK((order == std::vector<std::pair<int, int>>{
+        {1, 0}, {1, 1}, {2, 0}, {2, 0}, {2, 1}, {2, 2}}));
+}
+
+void test_references_are_passed_through() {
+    const std::vector<std::string> a{"apple", "cherry"};
+    const std::vector<std::string> b{"banana"};
+    auto refs = [](const std::vector<std::string>& v) -> std::generator<const std::string&> {
+        for (const std::string& s : v) {
+            co_yield s;
+        }
+    };
+    std::vector<const std::string*> seen;
+    for (const std::string& s : merge(refs(a), refs(b))) {
+        seen.push_back(&s);
+    }
+    CHECK((seen == std::vector{&a[0], &b[0], &a[1]}));
+}
+
+struct box {
+    std::unique_ptr<int> value;
+
+    friend bool operator<(const box& a, const box& b) {
+        return *a.value < *b.value;
+    }
+};
+
+void test_move_only_values_are_moved() {
+    auto boxes = [](std::vector<int> values) -> std::generator<box> {
+        for (int x : values) {
+            // Named, as GCC 12 destroys aggregate temporaries in a co_yield twice.
+            box b{std::make_unique<int>(x)};
+            co_yield std::move(b);
+        }
+    };
+    auto g = merge(boxes({1, 3}), boxes({2}));
+    std::vector<int> out;
+    for (auto it = g.begin(); it != g.end(); ++it) {
+        box b = it.take();
+        out.push_back(*b.value);
+    }
+    CHECK((out == std::vector{1, 2, 3}));
+}
+
+// Small and trivially copyable, but not default constructible.
+struct key {
+    explicit key(int v) : value(v) {}
+    int value;
+
+    friend bool operator<(const key& a, const key& b) {
+        return a.value < b.value;
+    }
+};
+
+void test_values_need_not_be_default_constructible() {
+    auto keys = [](std::vector<int> values) -> std::generator<key> {
+        for (int x : values) {
+            co_yield key{x};
+        }
+    };
+    std::vector<int> out;
+    for (const key& k : merge(keys({1, 4}), keys({2, 3}))) {
+        out.push_back(k.value);
+    }
+    CHECK((out == std::vector{1, 2, 3, 4}));
+}
+
+int main() {
+    RUN(test_merges_generators);
+    RUN(test_single_and_empty_inputs);
+    RUN(test_merges_range_of_many_generators);
+    RUN(test_ties_keep_input_order);
+    RUN(test_references_are_passed_through);
+    RUN(test_move_only_values_are_moved);
+    RUN(test_values_need_not_be_default_constructible);
+    return 0;
+}
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/mmap_lines>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::mmap_lines;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path write_file(const std::string& contents) {
+    const fs::path path = fs::temp_directory_path() / "stdgenerator-mmap-lines-test.txt";
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << contents;
+    return path;
+}
+
+std::vector<std::string> lines_of(const std::string& contents) {
+    std::vector<std::string> lines;
+    for (std::string_view line : mmap_lines(write_file(contents))) {
+        lines.emplace_back(line);
+    }
+    return lines;
+}
+
+void test_splits_lines() {
+    CHECK((lines_of("one\ntwo\nthree\n") == std::vector<std::string>{"one", "two", "three"}));
+}
+
+void test_like_getline() {
+    CHECK((lines_of("last line has no newline") ==
+           std::vector<std::string>{"last line has no newline"}));
+    CHECK((lines_of("\n\nx\n\n") == std::vector<std::string>{"", "", "x", ""}));
+    CHECK((lines_of("crlf\r\n") == std::vector<std::string>{"crlf\r"}));
+    CHECK(lines_of("").empty());
+}
+
+void test_views_point_into_one_mapping() {
+    auto lines = mmap_lines(write_file("alpha\nbeta\ngamma"));
+    std::vector<std::string_view> views;
+    for (std::string_view line : lines) {
+        views.push_back(line);
+    }
+    // Views stay valid for the lifetime of the generator.
+    CHECK(views.size() == 3);
+    CHECK(views[1].data() == views[0].data() + views[0].size() + 1);
+    CHECK(views[2].data() == views[1].data() + views[1].size() + 1);
+    CHECK(views[2] == "gamma");
+}
+
+void test_long_lines() {
+    std::string contents;
+    std::vector<std::string> expected;
+    for (std::size_t length : {0, 1, 15, 16, 17, 63, 64, 65, 127, 128, 1000, 5}) {
+        expected.emplace_back(length, 'a' + static_cast<char>(length % 26));
+        contents += expected.back() + "\n";
+    }
+    CHECK(lines_of(contents) == expected);
+}
+
+void test_find_newline_matches_memchr() {
+    std::mt19937 rng(5);
+    std::string buffer(300, 'x');
+    for (int round = 0; round < 2000; ++round) {
+        for (char& c : buffer) {
+            c = rng() % 40 == 0 ? '\n' : 'x';
+        }
+        const std::size_t first = rng() % buffer.size();
+        const std::size_t last = first + rng() % (buffer.size() - first + 1);
+        const char* begin = buffer.data() + first;
+        const char* end = buffer.data() + last;
+        const void* expected = std::memchr(begin, '\n', last - first);
+        CHECK(std::experimental::__find_newline(begin, end) ==
+              (expected ? static_cast<const char*>(expected) : end));
+    }
+}
+
+void test_missing_file_throws_on_begin() {
+    auto lines = mmap_lines(fs::temp_directory_path() / "stdgenerator-no-such-file.txt");
+    bool threw = false;
+    try {
+        (void)lines.begin();
+    } catch (const std::system_error& e) {
+        threw = e.code() == std::errc::no_such_file_or_directory;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    RUN(test_splits_lines);
+    RUN(test_like_getline);
+    RUN(test_views_point_into_one_mapping);
+    RUN(test_long_lines);
+    RUN(test_find_newline_matches_memchr);
+    RUN(test_missing_file_throws_on_begin);
+    fs::remove(fs::temp_directory_path() / "stdgenerator-mmap-lines-test.txt");
+    return 0;
+}
@@ -9,6 +9,7 @@
 #include <string>
 #include <string_view>
 #include <vector>
+#include <list>
 #include <memory>
 #include <exception>
 #include <atomic>
@@ -232,6 +233,247 @@ void test_yielding_elements_of_vector() {
     CHECK(it == g.end());
 }
 
+void test_yielding_elements_of_vector_does_not_allocate_frame() {
+    std::vector<int> v = {1, 2, 3};
+    auto makeGen = [&](std::allocator_arg_t, counting_allocator<std::byte>) -> std::generator<int> {
+        co_yield 0;
+        co_yield std::ranges::elements_of(v, counting_allocator<std::byte>{});
+        co_yield std::ranges::elements_of(v);
+        co_yield 4;
+    };
+
+    auto g = makeGen(std::allocator_arg, {});
+    const std::size_t outerFrameSize = counting_allocator_base::allocatedCount;
+
+    std::vector<int> values;
+    for (int x : g) {
+        values.push_back(x);
+        // Only the outer frame should have been allocated.
+        CHECK(counting_allocator_base::allocatedCount == outerFrameSize);
+    }
+    CHECK((values == std::vector{0, 1, 2, 3, 1, 2, 3, 4}));
+}
+
+void test_yielding_elements_of_generator_with_convertible_reference_does_not_allocate_frame() {
+    auto strings = []() -> std::generator<std::string> {
+        co_yield "a";
+        co_yield "b";
+    };
+    auto makeGen = [&]() -> std::generator<std::string_view, std::string_view, counting_allocator<std::byte>> {
+        co_yield std::ranges::elements_of(strings());
+        co_yield "c";
+    };
+
+    auto g = makeGen();
+    const std::size_t outerFrameSize = counting_allocator_base::allocatedCount;
+
+    std::vector<std::string> values;
+    for (std::string_view x : g) {
+        values.emplace_back(x);
+        // The inner generator is not wrapped in another frame.
+        CHECK(counting_allocator_base::allocatedCount == outerFrameSize);
+    }
+    CHECK((values == std::vector<std::string>{"a", "b", "c"}));
+}
+
+void test_yielding_elements_of_generator_with_convertible_reference_refers_to_value() {
+    std::vector<std::string> words = {"a", "b"};
+    auto inner = [&]() -> std::generator<std::string&> {
+        co_yield std::ranges::elements_of(words);
+    };
+    auto makeGen = [&]() -> std::generator<const std::string&> {
+        co_yield std::ranges::elements_of(inner());
+    };
+
+    auto g = makeGen();
+
+    auto it = g.begin();
+    const std::string& first = *it;
+    CHECK(&first == &words[0]);
+    ++it;
+    const std::string& second = *it;
+    CHECK(&second == &words[1]);
+    ++it;
+    CHECK(it == g.end());
+}
+
+void test_yielding_elements_of_nested_generator_with_convertible_reference() {
+    auto leaf = [](int n) -> std::generator<std::string> {
+        for (int i = 0; i < n; ++i) {
+            co_yield std::to_string(i);
+        }
+    };
+    auto middle = [&]() -> std::generator<std::string> {
+        co_yield std::ranges::elements_of(leaf(2));
+        co_yield std::ranges::elements_of(leaf(0));
+        co_yield "x";
+        co_yield std::ranges::elements_of(leaf(1));
+    };
+    auto outer = [&]() -> std::generator<std::string_view> {
+        co_yield std::ranges::elements_of(middle());
+        co_yield std::ranges::elements_of(middle());
+    };
+
+    std::string joined;
+    for (std::string_view x : outer()) {
+        joined += x;
+    }
+    CHECK(joined == "01x001x0");
+}
+
+void test_exception_from_generator_with_convertible_reference_reaches_producer() {
+    struct my_error : std::exception {};
+
+    bool caught = false;
+    auto makeGen = [&]() -> std::generator<std::string_view> {
+        try {
+            co_yield std::ranges::elements_of([]() -> std::generator<std::string> {
+                co_yield "a";
+                throw my_error{};
+            }());
+            CHECK(false);
+        } catch (const my_error&) {
+            caught = true;
+        }
+        co_yield "b";
+    };
+
+    auto g = makeGen();
+    auto it = g.begin();
+    CHECK(it != g.end());
+    CHECK(*it == "a");
+    ++it;
+    CHECK(caught);
+    CHECK(it != g.end());
+    CHECK(*it == "b");
+    ++it;
+    CHECK(it == g.end());
+}
+
+void test_destroying_generator_while_nested_with_convertible_reference() {
+    bool innerDestroyed = false;
+    bool outerDestroyed = false;
+    struct set_on_exit {
+        bool& flag;
+        ~set_on_exit() { flag = true; }
+    };
+    auto inner = [&]() -> std::generator<std::string> {
+        set_on_exit exit{innerDestroyed};
+        co_yield "a";
+        co_yield "b";
+    };
+    auto makeGen = [&]() -> std::generator<std::string_view> {
+        set_on_exit exit{outerDestroyed};
+        co_yield std::ranges::elements_of(inner());
+    };
+    {
+        auto g = makeGen();
+        auto it = g.begin();
+        CHECK(*it == "a");
+        ++it;
+        CHECK(*it == "b");
+        CHECK(!innerDestroyed);
+    }
+    CHECK(innerDestroyed);
+    CHECK(outerDestroyed);
+}
+
+void test_yielding_elements_of_vector_from_nested_generator() {
+    std::vector<std::string> words = {"a", "b"};
+    std::vector<std::string> empty;
+    auto inner = [&]() -> std::generator<const std::string&> {
+        co_yield std::ranges::elements_of(empty);
+        co_yield std::ranges::elements_of(words);
+        co_yield "c";
+    };
+    auto outer = [&]() -> std::generator<const std::string&> {
+        co_yield std::ranges::elements_of(inner());
+        co_yield std::ranges::elements_of(words);
+    };
+
+    std::vector<std::string> values;
+    for (const std::string& x : outer()) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector<std::string>{"a", "b", "c", "a", "b"}));
+}
+
+void test_yielding_elements_of_list() {
+    std::list<int> l = {5, 6, 7};
+    auto makeGen = [&]() -> std::generator<const int&> {
+        co_yield std::ranges::elements_of(l);
+        co_yield std::ranges::elements_of(std::list<int>{});
+        co_yield 8;
+    };
+
+    auto g = makeGen();
+
+    std::vector<int> values;
+    for (const int& x : g) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector{5, 6, 7, 8}));
+}
+
+void test_yielding_elements_of_generator_converting_to_reference_type() {
+    // Binding const long& to the inner generator's int creates a temporary,
+    // so the inner generator cannot be nested without an adapter frame.
+    auto inner = []() -> std::generator<int> {
+        co_yield 1000;
+        co_yield 2000;
+        co_yield 3000;
+    };
+    auto makeGen = [&]() -> std::generator<const long&> {
+        co_yield std::ranges::elements_of(inner());
+    };
+
+    std::vector<long> values;
+    for (const long& x : makeGen()) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector<long>{1000, 2000, 3000}));
+}
+
+void test_yielding_elements_of_range_converting_to_reference_type() {
+    // Binding const long& to an int creates a temporary, so the range
+    // cannot be walked by the consumer.
+    std::vector<int> v = {1000, 2000, 3000};
+    auto makeGen = [&]() -> std::generator<const long&> {
+        co_yield std::ranges::elements_of(v);
+    };
+
+    std::vector<long> values;
+    for (const long& x : makeGen()) {
+        values.push_back(x);
+    }
+    CHECK((values == std::vector<long>{1000, 2000, 3000}));
+}
+
+void test_exception_converting_elements_of_range_reaches_producer() {
+    struct my_error : std::exception {};
+    struct throws_on_convert {
+        operator int() const {
+            throw my_error{};
+        }
+    };
+
+    auto g = []() -> std::generator<int> {
+        std::vector<throws_on_convert> v(1);
+        try {
+            co_yield std::ranges::elements_of(v);
+            CHECK(false);
+        } catch (const my_error&) {
+        }
+        co_yield 7;
+    }();
+
+    auto it = g.begin();
+    CHECK(it != g.end());
+    CHECK(*it == 7);
+    ++it;
+    CHECK(it == g.end());
+}
+
 template<typename F>
 struct scope_guard {
     F f;
@@ -322,6 +564,17 @@ int main() {
     RUN(test_yielding_elements_of_generator_with_different_allocator_type);
     RUN(test_elementsof_with_allocator_args);
     RUN(test_yielding_elements_of_vector);
+    RUN(test_yielding_elements_of_vector_does_not_allocate_frame);
+    RUN(test_yielding_elements_of_generator_with_convertible_reference_does_not_allocate_frame);
+    RUN(test_yielding_elements_of_generator_with_convertible_reference_refers_to_value);
+    RUN(test_yielding_elements_of_nested_generator_with_convertible_reference);
+    RUN(test_exception_from_generator_with_convertible_reference_reaches_producer);
+    RUN(test_destroying_generator_while_nested_with_convertible_reference);
+    RUN(test_yielding_elements_of_vector_from_nested_generator);
+    RUN(test_yielding_elements_of_list);
+    RUN(test_yielding_elements_of_generator_converting_to_reference_type);
+    RUN(test_yielding_elements_of_range_converting_to_reference_type);
+    RUN(test_exception_converting_elements_of_range_reaches_producer);
     RUN(test_nested_generator_scopes_exit_innermost_scope_first);
     RUN(test_exception_propagating_from_nested_generator);
     return 0;
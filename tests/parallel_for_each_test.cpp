@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/parallel_for_each>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::parallel_for_each;
+using std::experimental::thread_pool;
+
+std::generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+void test_visits_every_value_once() {
+    thread_pool pool(4);
+    const int n = 100000;
+    std::vector<std::atomic<int>> seen(n);
+    parallel_for_each(iota(n), pool, [&](int x) { ++seen[x]; });
+    for (int i = 0; i < n; ++i) {
+        CHECK(seen[i] == 1);
+    }
+}
+
+void test_empty_generator() {
+    thread_pool pool(2);
+    int calls = 0;
+    parallel_for_each(iota(0), pool, [&](int) { ++calls; });
+    CHECK(calls == 0);
+}
+
+void test_runs_on_several_threads() {
+    thread_pool pool(4);
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    parallel_for_each(iota(2000), pool, [&](int) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    });
+    CHECK(ids.size() > 1);
+}
+
+void test_copies_values_of_reference_generators() {
+    thread_pool pool(2);
+    auto makeGen = []() -> std::generator<const std::string&> {
+        for (int i = 0; i < 1000; ++i) {
+            std::string s = std::to_string(i);
+            co_yield s;
+        }
+    };
+
+    std::atomic<long> total{0};
+    parallel_for_each(makeGen(), pool, [&](const std::string& s) {
+        total += std::stol(s);
+    });
+    CHECK(total == 999 * 1000 / 2);
+}
+
+void test_moves_values_of_rvalue_reference_generators() {
+    thread_pool pool(2);
+    auto makeGen = []() -> std::generator<std::unique_ptr<int>&&> {
+        for (int i = 1; i <= 100; ++i) {
+            co_yield std::make_unique<int>(i);
+        }
+    };
+
+    std::atomic<int> total{0};
+    parallel_for_each(makeGen(), pool, [&](std::unique_ptr<int>& p) { total += *p; });
+    CHECK(total == 5050);
+}
+
+void test_exception_from_function() {
+    struct my_error : std::exception {};
+
+    thread_pool pool(3);
+    std::atomic<int> calls{0};
+    bool caught = false;
+    try {
+        parallel_for_each(iota(1000000), pool, [&](int x) {
+            ++calls;
+            if (x == 100) {
+                throw my_error{};
+            }
+        });
+    } catch (const my_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK(calls < 1000000);
+}
+
+void test_exception_from_generator() {
+    struct my_error : std::exception {};
+
+    thread_pool pool(2);
+    auto makeGen = []() -> std::generator<int> {
+        for (int i = 0; i < 500; ++i) {
+            co_yield i;
+        }
+        throw my_error{};
+    };
+
+    std::atomic<int> calls{0};
+    bool caught = false;
+    try {
+        parallel_for_each(makeGen(), pool, [&](int) { ++calls; });
+    } catch (const my_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK(calls <= 500);
+}
+
+void test_pool_is_reusable() {
+    thread_pool pool(2);
+    for (int round = 0; round < 20; ++round) {
+        std::atomic<int> total{0};
+        parallel_for_each(iota(100), pool, [&](int x) { total += x; });
+        CHECK(total == 4950);
+    }
+}
+
+int main() {
+    RUN(test_visits_every_value_once);
+    RUN(test_empty_generator);
+    RUN(test_runs_on_several_threads);
+    RUN(test_copies_values_of_reference_generators);
+    RUN(test_moves_values_of_rvalue_reference_generators);
+    RUN(test_exception_from_function);
+    RUN(test_exception_from_generator);
+    RUN(test_pool_is_reusable);
+    return 0;
+}
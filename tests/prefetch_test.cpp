@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/prefetch>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::prefetch;
+
+std::generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+void test_values_arrive_in_order() {
+    for (std::size_t capacity : {1, 3, 64}) {
+        int expected = 0;
+        for (int x : prefetch(iota(1000), capacity)) {
+            CHECK(x == expected);
+            ++expected;
+        }
+        CHECK(expected == 1000);
+    }
+}
+
+void test_empty_source() {
+    auto g = prefetch(iota(0));
+    CHECK(g.begin() == g.end());
+}
+
+void test_producer_runs_on_worker_thread() {
+    const std::thread::id consumerThread = std::this_thread::get_id();
+    auto makeGen = []() -> std::generator<std::thread::id> {
+        co_yield std::this_thread::get_id();
+    };
+
+    for (std::thread::id id : prefetch(makeGen())) {
+        CHECK(id != consumerThread);
+    }
+}
+
+void test_move_only_values() {
+    auto makeGen = []() -> std::generator<std::unique_ptr<std::string>&&> {
+        for (int i = 0; i < 10; ++i) {
+            co_yield std::make_unique<std::string>(std::to_string(i));
+        }
+    };
+
+    std::vector<std::string> values;
+    for (std::unique_ptr<std::string>&& p : prefetch(makeGen(), 4)) {
+        std::unique_ptr<std::string> owned = std::move(p);
+        values.push_back(*owned);
+    }
+    CHECK(values.size() == 10);
+    CHECK(values.front() == "0");
+    CHECK(values.back() == "9");
+}
+
+void test_exception_after_values() {
+    struct my_error : std::exception {};
+
+    auto makeGen = []() -> std::generator<int> {
+        co_yield 1;
+        co_yield 2;
+        throw my_error{};
+    };
+
+    std::vector<int> values;
+    bool caught = false;
+    try {
+        for (int x : prefetch(makeGen())) {
+            values.push_back(x);
+        }
+    } catch (const my_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK((values == std::vector{1, 2}));
+}
+
+void test_early_destruction_stops_producer() {
+    static std::atomic<int> live{0};
+    struct counted {
+        int value;
+        explicit counted(int v) : value(v) { ++live; }
+        counted(counted&& other) noexcept : value(other.value) { ++live; }
+        ~counted() { --live; }
+    };
+
+    std::atomic<bool> sourceDestroyed{false};
+    struct on_exit {
+        std::atomic<bool>& flag;
+        ~on_exit() { flag = true; }
+    };
+
+    auto infinite = [&]() -> std::generator<counted&&> {
+        on_exit guard{sourceDestroyed};
+        for (int i = 0;; ++i) {
+            co_yield counted{i};
+        }
+    };
+
+    {
+        auto g = prefetch(infinite(), 8);
+        auto it = g.begin();
+        for (int i = 0; i < 3; ++i) {
+            CHECK(it != g.end());
+            CHECK((*it).value == i);
+            ++it;
+        }
+    }
+    CHECK(sourceDestroyed);
+    CHECK(live == 0);
+}
+
+void test_destroy_before_iterating() {
+    auto g = prefetch(iota(10));
+}
+
+int main() {
+    RUN(test_values_arrive_in_order);
+    RUN(test_empty_source);
+    RUN(test_producer_runs_on_worker_thread);
+    RUN(test_move_only_values);
+    RUN(test_exception_after_values);
+    RUN(test_early_destruction_stops_producer);
+    RUN(test_destroy_before_iterating);
+    return 0;
+}
@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/read_chunks>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "check.hpp"
+
+using std::experimental::read_chunks;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const fs::path path = fs::temp_directory_path() / "stdgenerator-read-chunks-test.bin";
+
+std::string pattern(std::size_t size) {
+    std::string s(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        s[i] = static_cast<char>('a' + i % 23);
+    }
+    return s;
+}
+
+int open_file(const std::string& contents) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+    return ::open(path.c_str(), O_RDONLY);
+}
+
+struct chunks {
+    std::string data;
+    std::vector<std::size_t> sizes;
+    std::set<const std::byte*> buffers;
+};
+
+chunks read_all(int fd, std::size_t chunk_size) {
+    chunks result;
+    for (std::span<const std::byte> chunk : read_chunks(fd, chunk_size)) {
+        result.data.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+        result.sizes.push_back(chunk.size());
+        result.buffers.insert(chunk.data());
+    }
+    return result;
+}
+
+void test_reads_file_in_chunks() {
+    const std::string contents = pattern(10000);
+    const int fd = open_file(contents);
+    const chunks c = read_all(fd, 4096);
+    CHECK(c.data == contents);
+    CHECK((c.sizes == std::vector<std::size_t>{4096, 4096, 1808}));
+    ::close(fd);
+}
+
+void test_exact_multiple_and_empty_files() {
+    int fd = open_file(pattern(8192));
+    CHECK((read_all(fd, 4096).sizes == std::vector<std::size_t>{4096, 4096}));
+    ::close(fd);
+
+    fd = open_file("");
+    CHECK(read_all(fd, 4096).sizes.empty());
+    ::close(fd);
+}
+
+void test_buffers_are_recycled() {
+    const int fd = open_file(pattern(100 * 1024));
+    const chunks c = read_all(fd, 1024);
+    CHECK(c.sizes.size() == 100);
+    CHECK(c.buffers.size() == 2);
+    ::close(fd);
+}
+
+void test_starts_at_offset_and_leaves_it_unchanged() {
+    const std::string contents = pattern(5000);
+    const int fd = open_file(contents);
+    ::lseek(fd, 1000, SEEK_SET);
+    CHECK(read_all(fd, 1024).data == contents.substr(1000));
+    CHECK(::lseek(fd, 0, SEEK_CUR) == 1000);
+    ::close(fd);
+}
+
+void test_reads_pipes() {
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    const std::string contents = pattern(300 * 1000);
+    std::thread writer([&] {
+        // Small writes, so that reads return partial chunks.
+        for (std::size_t i = 0; i < contents.size(); i += 777) {
+            const std::size_t n = std::min<std::size_t>(777, contents.size() - i);
+            CHECK(::write(fds[1], contents.data() + i, n) == static_cast<ssize_t>(n));
+        }
+        ::close(fds[1]);
+    });
+    const chunks c = read_all(fds[0], 64 * 1024);
+    writer.join();
+    ::close(fds[0]);
+    CHECK(c.data == contents);
+    CHECK(c.sizes.size() == 5);
+    CHECK(c.sizes.front() == 64 * 1024);
+}
+
+void test_destroying_generator_early_stops_reader() {
+    const int fd = open_file(pattern(1 << 20));
+    {
+        auto g = read_chunks(fd, 4096);
+        auto it = g.begin();
+        CHECK((*it).size() == 4096);
+    }
+    ::close(fd);
+}
+
+void test_read_error_throws() {
+    bool threw = false;
+    try {
+        for (auto chunk : read_chunks(-1, 4096)) {
+            (void)chunk;
+        }
+    } catch (const std::system_error& e) {
+        threw = e.code() == std::errc::bad_file_descriptor;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    RUN(test_reads_file_in_chunks);
+    RUN(test_exact_multiple_and_empty_files);
+    RUN(test_buffers_are_recycled);
+    RUN(test_starts_at_offset_and_leaves_it_unchanged);
+    RUN(test_reads_pipes);
+    RUN(test_destroying_generator_early_stops_reader);
+    RUN(test_read_error_throws);
+    fs::remove(path);
+    return 0;
+}
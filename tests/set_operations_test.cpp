@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <generator>
+#include <experimental/set_operations>
+#include <algorithm>
+#include <vector>
+
+#include "check.hpp"
+
+using std::experimental::gallop_lower_bound;
+using std::experimental::set_intersection;
+using std::experimental::set_union;
+using std::experimental::sorted_elements;
+
+std::generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+// Like sorted_elements(), but counts the values it yields.
+std::generator<int> counted(const std::vector<int>& values, int& yielded) {
+    auto it = values.begin();
+    while (it != values.end()) {
+        ++yielded;
+        if (const int* key = co_yield std::ranges::seekable(*it)) {
+            it = gallop_lower_bound(it, values.end(), *key);
+        } else {
+            ++it;
+        }
+    }
+}
+
+template <typename Gen>
+std::vector<int> collect(Gen&& g) {
+    std::vector<int> out;
+    for (int x : g) {
+        out.push_back(x);
+    }
+    return out;
+}
+
+void test_skip_to_steps_through_generators_that_do_not_seek() {
+    auto g = iota(10);
+    auto it = g.begin();
+    it.skip_to(4);
+    CHECK(*it == 4);
+    // Skipping to a key not greater than the current value is a no-op.
+    it.skip_to(2);
+    CHECK(*it == 4);
+    it.skip_to(100);
+    CHECK(it == g.end());
+}
+
+void test_skip_to_hands_key_to_seekable_producer() {
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i * 2);
+    }
+    int yielded = 0;
+    auto g = counted(values, yielded);
+    auto it = g.begin();
+    it.skip_to(901);
+    CHECK(*it == 902);
+    CHECK(yielded == 2);
+    ++it;
+    CHECK(*it == 904);
+    CHECK(yielded == 3);
+    it.skip_to(5000);
+    CHECK(it == g.end());
+}
+
+void test_skip_to_reaches_seekable_nested_generator() {
+    const std::vector<int> values{1, 3, 5, 7, 9, 11};
+    int yielded = 0;
+    auto outer = [&]() -> std::generator<int> {
+        co_yield 0;
+        co_yield std::ranges::elements_of(counted(values, yielded));
+        co_yield 20;
+    };
+    auto g = outer();
+    auto it = g.begin();
+    it.skip_to(8);
+    CHECK(*it == 9);
+    CHECK(yielded == 2);
+    it.skip_to(12);
+    CHECK(*it == 20);
+}
+
+void test_gallop_lower_bound_matches_lower_bound() {
+    std::vector<int> values;
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(i * 3);
+    }
+    for (std::size_t start = 0; start <= values.size(); ++start) {
+        for (int key = -1; key <= 301; ++key) {
+            auto first = values.begin() + start;
+            CHECK(gallop_lower_bound(first, values.end(), key) ==
+                  std::lower_bound(first, values.end(), key));
+        }
+    }
+}
+
+void test_sorted_elements_seeks() {
+    const std::vector<int> values{2, 4, 8, 16, 32, 64};
+    auto g = sorted_elements(values);
+    auto it = g.begin();
+    it.skip_to(10);
+    CHECK(*it == 16);
+    it.skip_to(64);
+    CHECK(*it == 64);
+    ++it;
+    CHECK(it == g.end());
+}
+
+void test_intersection() {
+    const std::vector<int> a{1, 2, 4, 6, 8, 9, 12};
+    const std::vector<int> b{0, 2, 3, 6, 9, 10, 12, 14};
+    const std::vector<int> empty;
+    CHECK((collect(set_intersection(sorted_elements(a), sorted_elements(b))) ==
+           std::vector{2, 6, 9, 12}));
+    CHECK(collect(set_intersection(sorted_elements(a), sorted_elements(empty))).empty());
+    // Inputs that do not seek work too.
+    CHECK((collect(set_intersection(iota(10), sorted_elements(a))) ==
+           std::vector{1, 2, 4, 6, 8, 9}));
+}
+
+void test_sparse_intersection_is_sublinear() {
+    std::vector<int> dense;
+    for (int i = 0; i < 100000; ++i) {
+        dense.push_back(i);
+    }
+    const std::vector<int> sparse{10, 50000, 99999};
+    int denseYielded = 0;
+    int sparseYielded = 0;
+    CHECK(collect(set_intersection(counted(dense, denseYielded),
+                                   counted(sparse, sparseYielded))) == sparse);
+    CHECK(denseYielded <= 6);
+    CHECK(sparseYielded == 3);
+}
+
+void test_union() {
+    const std::vector<int> a{1, 2, 4, 6};
+    const std::vector<int> b{0, 2, 3, 6, 9};
+    const std::vector<int> empty;
+    CHECK((collect(set_union(sorted_elements(a), sorted_elements(b))) ==
+           std::vector{0, 1, 2, 3, 4, 6, 9}));
+    CHECK(collect(set_union(sorted_elements(empty), sorted_elements(a))) == a);
+    CHECK(collect(set_union(sorted_elements(a), sorted_elements(empty))) == a);
+}
+
+void test_skip_to_on_combined_generators() {
+    std::vector<int> evens;
+    std::vector<int> odds;
+    std::vector<int> tens;
+    for (int i = 0; i < 10000; ++i) {
+        (i % 2 == 0 ? evens : odds).push_back(i);
+        if (i % 10 == 0) {
+            tens.push_back(i);
+        }
+    }
+    int evensYielded = 0;
+    int oddsYielded = 0;
+    auto g = set_intersection(
+        set_union(counted(evens, evensYielded), counted(odds, oddsYielded)),
+        sorted_elements(tens));
+    auto it = g.begin();
+    CHECK(*it == 0);
+    it.skip_to(9001);
+    CHECK(*it == 9010);
+    ++it;
+    CHECK(*it == 9020);
+    // Every skip passes through the union to both inputs.
+    CHECK(evensYielded < 100);
+    CHECK(oddsYielded < 100);
+}
+
+int main() {
+    RUN(test_skip_to_steps_through_generators_that_do_not_seek);
+    RUN(test_skip_to_hands_key_to_seekable_producer);
+    RUN(test_skip_to_reaches_seekable_nested_generator);
+    RUN(test_gallop_lower_bound_matches_lower_bound);
+    RUN(test_sorted_elements_seeks);
+    RUN(test_intersection);
+    RUN(test_sparse_intersection_is_sublinear);
+    RUN(test_union);
+    RUN(test_skip_to_on_combined_generators);
+    return 0;
+}
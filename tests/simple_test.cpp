@@ -6,8 +6,10 @@
 // (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
 ///////////////////////////////////////////////////////////////////////////////
 #include <generator>
+#include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "check.hpp"
 
@@ -166,6 +168,125 @@ void test_dereference_iterator_copies_reference() {
     CHECK(ctorCount == dtorCount);
 }
 
+void test_move_only_reference_type() {
+    auto g = []() -> std::generator<std::unique_ptr<int>&&> {
+        co_yield std::make_unique<int>(1);
+        co_yield std::make_unique<int>(2);
+    }();
+
+    int expected = 1;
+    for (std::unique_ptr<int>&& p : g) {
+        std::unique_ptr<int> owned = std::move(p);
+        CHECK(*owned == expected);
+        ++expected;
+    }
+    CHECK(expected == 3);
+}
+
+void test_yielded_lvalue_is_not_copied() {
+    static size_t copyCount = 0;
+    struct X {
+        int value = 0;
+        X() = default;
+        X(const X& other) : value(other.value) { ++copyCount; }
+    };
+
+    auto g = []() -> std::generator<X> {
+        X x;
+        x.value = 1;
+        co_yield x;
+        x.value = 2;
+        co_yield x;
+        const X y;
+        co_yield y;
+    }();
+
+    int expected[] = {1, 2, 0};
+    size_t index = 0;
+    for (auto it = g.begin(); it != g.end(); ++it) {
+        // Dereferencing still returns a copy, but only that one.
+        auto before = copyCount;
+        X x = *it;
+        CHECK(copyCount == before + 1);
+        CHECK(x.value == expected[index]);
+        ++index;
+    }
+    CHECK(index == 3);
+    CHECK(copyCount == 3);
+}
+
+void test_take_moves_owned_values() {
+    static size_t copyCount = 0;
+    static size_t moveCount = 0;
+    struct X {
+        X() = default;
+        X(const X&) { ++copyCount; }
+        X(X&&) noexcept { ++moveCount; }
+    };
+
+    auto g = []() -> std::generator<X> {
+        co_yield X{};
+        X lvalue;
+        co_yield lvalue;
+    }();
+
+    auto it = g.begin();
+    X first = it.take();
+    CHECK(copyCount == 0);
+    // Moved into the promise, then out of it.
+    CHECK(moveCount == 2);
+
+    ++it;
+    // The producer's own object is copied, not moved from.
+    X second = it.take();
+    CHECK(copyCount == 1);
+    CHECK(moveCount == 2);
+    (void)first;
+    (void)second;
+}
+
+void test_take_from_reference_types() {
+    std::string stored = "stored";
+    auto byRef = [&]() -> std::generator<const std::string&> {
+        co_yield stored;
+    };
+    auto g1 = byRef();
+    std::string copy = g1.begin().take();
+    CHECK(copy == "stored");
+    CHECK(stored == "stored");
+
+    auto byRvalueRef = []() -> std::generator<std::unique_ptr<int>&&, std::unique_ptr<int>,
+                                              std::allocator<std::byte>> {
+        co_yield std::make_unique<int>(42);
+    };
+    auto g2 = byRvalueRef();
+    std::unique_ptr<int> owned = g2.begin().take();
+    CHECK(*owned == 42);
+}
+
+void test_take_builds_container_without_copies() {
+    std::vector<const int*> produced;
+    auto rowsOf = [](std::vector<const int*>& produced) -> std::generator<std::vector<int>> {
+        for (int i = 0; i < 3; ++i) {
+            std::vector<int> row(100, i);
+            produced.push_back(row.data());
+            co_yield std::move(row);
+        }
+    };
+    auto g = rowsOf(produced);
+
+    std::vector<std::vector<int>> rows;
+    for (auto it = g.begin(); it != g.end(); ++it) {
+        rows.push_back(it.take());
+    }
+    CHECK(rows.size() == 3);
+    CHECK(rows[2][99] == 2);
+    // Each row still owns the buffer the producer allocated.
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        CHECK(rows[i].data() == produced[i]);
+    }
+}
+
 int main() {
     RUN(test_default_constructor);
     RUN(test_empty_generator);
@@ -174,5 +295,10 @@ int main() {
     RUN(test_range_based_for_loop_2);
     RUN(test_range_based_for_loop_3);
     RUN(test_dereference_iterator_copies_reference);
+    RUN(test_move_only_reference_type);
+    RUN(test_yielded_lvalue_is_not_copied);
+    RUN(test_take_moves_owned_values);
+    RUN(test_take_from_reference_types);
+    RUN(test_take_builds_container_without_copies);
     return 0;
 }
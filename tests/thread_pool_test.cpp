@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+// Copyright Lewis Baker, Corentin Jabot
+//
+// Use, modification and distribution is subject to the Boost Software License,
+// Version 1.0.
+// (See accompanying file LICENSE or http://www.boost.org/LICENSE_1_0.txt)
+///////////////////////////////////////////////////////////////////////////////
+#include <experimental/thread_pool>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "check.hpp"
+
+using std::experimental::thread_pool;
+
+void test_destructor_runs_submitted_tasks() {
+    std::atomic<int> count{0};
+    {
+        thread_pool pool(4);
+        CHECK(pool.size() == 4);
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit([&] { ++count; });
+        }
+    }
+    CHECK(count == 1000);
+}
+
+void test_tasks_run_on_pool_threads() {
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    {
+        thread_pool pool(2);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&] {
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.insert(std::this_thread::get_id());
+            });
+        }
+    }
+    CHECK(!ids.empty());
+    CHECK(ids.size() <= 2);
+    CHECK(ids.count(std::this_thread::get_id()) == 0);
+}
+
+void test_tasks_submitting_tasks() {
+    std::atomic<int> count{0};
+    {
+        thread_pool pool(3);
+        struct spawner {
+            thread_pool& pool;
+            std::atomic<int>& count;
+            int depth;
+
+            void operator()() const {
+                ++count;
+                if (depth > 0) {
+                    pool.submit(spawner{pool, count, depth - 1});
+                    pool.submit(spawner{pool, count, depth - 1});
+                }
+            }
+        };
+        pool.submit(spawner{pool, count, 9});
+    }
+    CHECK(count == 1023);
+}
+
+void test_run_pending_task_on_calling_thread() {
+    thread_pool pool(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    pool.submit([&] {
+        started = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    // The only worker is busy, so the task can only run here.
+    bool ran = false;
+    pool.submit([&] { ran = true; });
+    CHECK(pool.__run_pending_task());
+    CHECK(ran);
+    CHECK(!pool.__run_pending_task());
+    release = true;
+}
+
+int main() {
+    RUN(test_destructor_runs_submitted_tasks);
+    RUN(test_tasks_run_on_pool_threads);
+    RUN(test_tasks_submitting_tasks);
+    RUN(test_run_pending_task_on_calling_thread);
+    return 0;
+}